@@ -1,7 +1,16 @@
-#include <vector>
-#include <cstdlib>
-#include <ctime>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#else
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#include "InputRing.h"
+#include "Replay.h"
+#include "Rng.h"
+#include "SessionPool.h"
+#include "Snapshot.h"
 
 // Minimal Flappy Bird clone for WASM export
 // Board is a simple character grid read from JS via _flappy_get_cell
@@ -11,158 +20,632 @@ extern "C" {
 // Game parameters
 static const int FB_WIDTH = 28;
 static const int FB_HEIGHT = 20;
-// Default to Normal difficulty implicitly
-static int PIPE_GAP = 8;            // vertical gap size (Normal)
-static const int PIPE_SPACING = 13; // columns between pipes
+static const int PIPE_SPACING = 13; // columns between pipes at the start of a course
 static const int BIRD_X = 6;        // fixed x position of bird
+// Dirty entries kept between flappy_clear_dirty() calls; past this a full re-read is as cheap
+static const int FB_DIRTY_CAP = FB_WIDTH * FB_HEIGHT;
 
-// Game state
-static bool fb_initialized = false;
-static bool fb_game_over = false;
-static bool fb_started = false; // game hasn't started until first flap
-static int fb_score = 0;
-static int fb_tick = 0;
-// Physics (floating point for smoother motion)
-static double birdYf = FB_HEIGHT / 2.0;
-static double birdVyf = 0.0;
+// Physics runs in fixed steps of FB_STEP_MS on Q16 fixed point (FB_FP_ONE is
+// one cell), so a game plays out bit-identically on every platform.
+// Velocities are in cells per step.
+static const int FB_FP_SHIFT = 16;
+static const int32_t FB_FP_ONE = 1 << FB_FP_SHIFT;
+static const int32_t FB_GRAVITY = 4404;        // 0.0672 cells/step^2
+static const int32_t FB_FLAP_VY = -56885;      // -0.868
+static const int32_t FB_MAX_FALL_VY = 71565;   // 1.092
+static const int32_t FB_MAX_RISE_VY = -82575;  // -1.26
+static const int32_t FB_CEILING_Y = -FB_HEIGHT * FB_FP_ONE; // highest the bird flies, a board above the top
+static const int32_t FB_PIPE_SPEED = FB_FP_ONE / 5; // a cell every 5 steps, in sub-cell moves
+static const int FB_STEP_MS = 20;
+static const int FB_MAX_ADVANCE_MS = 100; // longer stalls are dropped, not caught up
 
+// Replay log format; param 0 is pipe_gap. The only input is a flap.
+static const int32_t FB_REPLAY_TAG = 0x33504C46; // "FLP3" (generated course)
+static const int FB_INPUT_FLAP = 0;
+
+// Course generator: pipes are laid out ahead of need into a lookahead ring,
+// topped up by at most FB_COURSE_PER_STEP per step so no frame ever pays for
+// a whole chunk. Difficulty ramps over the first FB_RAMP_PIPES pipes: spacing
+// tightens, gaps narrow down to pipe_gap and may wander further from the
+// previous one. The margins keep every gap top within one flap's climb of
+// any other (see the static_assert below), so no course is impossible.
+static const int FB_COURSE_LOOKAHEAD = 16; // power of two
+static const int FB_COURSE_PER_STEP = 1;
+static const int FB_RAMP_PIPES = 40;
+static const int FB_MIN_SPACING = 9;
+static const int FB_GAP_EXTRA = 2;  // extra gap rows on the first pipes
+static const int FB_GAP_MARGIN = 4; // rows kept solid above and below a gap
+struct CourseSlot {
+  int16_t spacing; // columns after the previous pipe
+  int16_t gapY, gapH;
+};
+
+// flappy_snapshot layout: tag, FlappySnapshot, Rng, SeedChain, then
+// pipe_count pipes as (int32 screen x, int16 gapY, int16 gapH), then
+// course_count CourseSlots.
+static const uint32_t FB_SNAPSHOT_TAG = 0x33534C46; // "FLS3"
+struct FlappySnapshot {
+  int32_t pipe_gap, game_over, started, score, tick, bird_y, bird_vy, pipe_count;
+  int32_t course_index, course_center, course_count;
+};
+
+// Entity export read by the renderer: bird y (fixed point), pipe count, then
+// per pipe x (fixed point), gapY and gap height, all int32. Rewritten every
+// step, so a frame needs one HEAP32 read instead of a cell query per tile.
+static const int FB_ENTITY_HEADER = 2;
+static const int FB_ENTITY_STRIDE = 3;
+
+// Pipes live in a fixed ring, leftmost first. Their x is a world coordinate
+// and the screen x is x - scroll, so scrolling moves no pipes; the pool is
+// sized for boards far wider than this one.
+static const int FB_PIPE_CAPACITY = 64; // power of two
 struct Pipe {
-  int x;   // column index of the pipe
-  int gapY; // top of the gap (inclusive)
+  int64_t x; // left edge in world space, fixed point
+  int gapY;  // top of the gap (inclusive)
+  int gapH;  // gap rows
+};
+
+// Column or row holding a fixed-point coordinate (floor)
+static inline int fp_cell(int32_t v) { return v >> FB_FP_SHIFT; }
+
+// One game; the exported API acts on the session selected with flappy_use().
+struct FlappySession {
+  // Default to Normal difficulty implicitly
+  int pipe_gap = 8; // vertical gap size (Normal)
+
+  // Game state
+  bool game_over = false;
+  bool started = false; // game hasn't started until first flap
+  int score = 0;
+  int tick = 0;
+  // Bird position and velocity, fixed point
+  int32_t bird_y = FB_HEIGHT * FB_FP_ONE / 2;
+  int32_t bird_vy = 0;
+
+  // For flappy_advance and interpolated rendering: real time not yet turned
+  // into steps, and the bird's y before the last step
+  double pending_ms = 0;
+  int32_t prev_bird_y = FB_HEIGHT * FB_FP_ONE / 2;
+  bool scrolled = false; // pipes moved on the last step
+
+  int32_t entities[FB_ENTITY_HEADER + FB_PIPE_CAPACITY * FB_ENTITY_STRIDE] = {};
+
+  Pipe pipes[FB_PIPE_CAPACITY] = {};
+  int pipe_head = 0;      // ring slot of the leftmost pipe
+  int pipe_count = 0;
+  int64_t scroll = 0;     // world x of the screen's left edge, fixed point
+  int64_t rightmost_x = 0; // world x of the newest pipe
+
+  // Generated pipes not yet placed, oldest first (see FB_COURSE_LOOKAHEAD)
+  CourseSlot course[FB_COURSE_LOOKAHEAD] = {};
+  int course_head = 0;
+  int course_count = 0;
+  int course_index = 0;  // pipes generated this game, drives the ramp
+  int course_center = FB_HEIGHT / 2; // middle row of the last generated gap
+
+  // Course generation; reseeded on every flappy_start_game()
+  Rng rng;
+  SeedChain seeds;
+
+  // This game's seed and flaps, keyed by tick (see Replay.h)
+  ReplayLog replay;
+
+  // Flap inputs from JS, drained at the start of every step
+  InputRing input;
+
+  // Last frame handed to JS, used to diff touched columns into the dirty list.
+  // Dirty entries are (index, value) pairs accumulated since flappy_clear_dirty();
+  // dirty_count == -1 means the whole board must be re-read.
+  unsigned char frame[FB_WIDTH * FB_HEIGHT] = {};
+  int dirty[FB_DIRTY_CAP * 2] = {};
+  int dirty_count = -1;
+  bool col_touched[FB_WIDTH] = {};
 };
 
-static std::vector<Pipe> pipes;
+static SessionPool<FlappySession> fb_sessions;
+static FlappySession* fb = fb_sessions.defaultSession();
+
+static inline int bird_row(const FlappySession &s) { return fp_cell(s.bird_y + FB_FP_ONE / 2); }
+
+// i-th pipe from the left
+static inline const Pipe &pipe_at(const FlappySession &s, int i) {
+  return s.pipes[(s.pipe_head + i) & (FB_PIPE_CAPACITY - 1)];
+}
+
+static inline int32_t screen_x(const FlappySession &s, const Pipe &p) { return (int32_t)(p.x - s.scroll); }
+
+// Appends at world x; pipes must arrive in increasing x. No-op when full.
+static void push_pipe(FlappySession &s, int64_t x, int gapY, int gapH) {
+  if (s.pipe_count == FB_PIPE_CAPACITY) return;
+  Pipe &p = s.pipes[(s.pipe_head + s.pipe_count) & (FB_PIPE_CAPACITY - 1)];
+  p.x = x;
+  p.gapY = gapY;
+  p.gapH = gapH;
+  ++s.pipe_count;
+  s.rightmost_x = x;
+}
+
+static void pop_pipe(FlappySession &s) {
+  s.pipe_head = (s.pipe_head + 1) & (FB_PIPE_CAPACITY - 1);
+  --s.pipe_count;
+}
+
+// Height one flap gains before the bird starts falling again, in fixed point
+static constexpr int32_t flap_climb() {
+  int32_t y = 0, vy = FB_FLAP_VY;
+  while (vy + FB_GRAVITY < 0) {
+    vy += FB_GRAVITY;
+    y -= vy;
+  }
+  return y;
+}
+
+// Gap tops span FB_HEIGHT - gapH - 2 * FB_GAP_MARGIN rows at most, which a
+// single flap covers even for the narrowest gap (pipe_gap 7). Pipes are at
+// least (FB_MIN_SPACING - 1) * 5 steps apart, far longer than a flap takes,
+// and falling is never the limit, so every course can be flown.
+static_assert((FB_HEIGHT - 7 - 2 * FB_GAP_MARGIN) * FB_FP_ONE <= flap_climb(),
+              "gap margins must keep every gap within one flap of the last");
+
+// Lays out the next pipe of the course into the lookahead ring
+static void generate_pipe(FlappySession &s) {
+  const int ramp = s.course_index < FB_RAMP_PIPES ? s.course_index : FB_RAMP_PIPES;
+  ++s.course_index;
+  CourseSlot c;
+  c.spacing = (int16_t)(PIPE_SPACING - (PIPE_SPACING - FB_MIN_SPACING) * ramp / FB_RAMP_PIPES);
+  c.gapH = (int16_t)(s.pipe_gap + (FB_GAP_EXTRA * (FB_RAMP_PIPES - ramp) + FB_RAMP_PIPES - 1) / FB_RAMP_PIPES);
+
+  // How far the gap's middle may move from the last one
+  const int wander = 3 + FB_HEIGHT * ramp / FB_RAMP_PIPES;
+  const int keep = s.course_center - c.gapH / 2; // gapY with an unmoved middle
+  int lo = FB_GAP_MARGIN, hi = FB_HEIGHT - c.gapH - FB_GAP_MARGIN;
+  if (lo < keep - wander) lo = keep - wander;
+  if (hi > keep + wander) hi = keep + wander;
+  if (lo <= hi) {
+    c.gapY = (int16_t)s.rng.range(lo, hi);
+  } else {
+    // The margins alone exclude every row in reach; stay as close as they allow
+    c.gapY = (int16_t)(keep < FB_GAP_MARGIN ? FB_GAP_MARGIN : FB_HEIGHT - c.gapH - FB_GAP_MARGIN);
+  }
+  s.course_center = c.gapY + c.gapH / 2;
+  s.course[(s.course_head + s.course_count) & (FB_COURSE_LOOKAHEAD - 1)] = c;
+  ++s.course_count;
+}
+
+// Generates up to n pipes while the lookahead has room
+static void fill_course(FlappySession &s, int n) {
+  while (n-- > 0 && s.course_count < FB_COURSE_LOOKAHEAD) generate_pipe(s);
+}
+
+static CourseSlot take_course(FlappySession &s) {
+  if (s.course_count == 0) generate_pipe(s); // only if placement outran the top-ups
+  CourseSlot c = s.course[s.course_head];
+  s.course_head = (s.course_head + 1) & (FB_COURSE_LOOKAHEAD - 1);
+  --s.course_count;
+  return c;
+}
+
+static int cell_at(const FlappySession &s, int x, int y) {
+  // bird
+  if (x == BIRD_X && y == bird_row(s)) return 'B';
+
+  // pipes, left to right
+  for (int i = 0; i < s.pipe_count; ++i) {
+    const Pipe &p = pipe_at(s, i);
+    int col = fp_cell(screen_x(s, p));
+    if (col < x) continue;
+    if (col == x && (y < p.gapY || y >= p.gapY + p.gapH)) return '#';
+    break;
+  }
+
+  // background
+  return ' ';
+}
+
+static void export_entities(FlappySession &s) {
+  for (int i = 0; i < s.pipe_count; ++i) {
+    const Pipe &p = pipe_at(s, i);
+    int32_t* e = s.entities + FB_ENTITY_HEADER + i * FB_ENTITY_STRIDE;
+    e[0] = screen_x(s, p);
+    e[1] = p.gapY;
+    e[2] = p.gapH;
+  }
+  s.entities[0] = s.bird_y;
+  s.entities[1] = s.pipe_count;
+}
 
-static inline int irand(int minVal, int maxVal) {
-  return minVal + (std::rand() % (maxVal - minVal + 1));
+static void render_full_frame(FlappySession &s) {
+  export_entities(s);
+  for (int y = 0; y < FB_HEIGHT; ++y)
+    for (int x = 0; x < FB_WIDTH; ++x) s.frame[y * FB_WIDTH + x] = (unsigned char)cell_at(s, x, y);
+  s.dirty_count = -1;
 }
 
-static void fb_reset() {
-  if (!fb_initialized) {
-    std::srand((unsigned)std::time(nullptr));
-    fb_initialized = true;
+// Only the bird column and columns holding a pipe before or after the tick can change
+static void touch_entity_columns(FlappySession &s) {
+  s.col_touched[BIRD_X] = true;
+  for (int i = 0; i < s.pipe_count; ++i) {
+    int col = fp_cell(screen_x(s, pipe_at(s, i)));
+    if (col >= FB_WIDTH) break;
+    if (col >= 0) s.col_touched[col] = true;
   }
-  fb_game_over = false;
-  fb_started = false; // require first click to start
-  fb_score = 0;
-  fb_tick = 0;
-  birdYf = FB_HEIGHT / 2.0; // center bird
-  birdVyf = 0.0;            // no velocity at start
-  pipes.clear();
+}
+
+static void diff_touched_columns(FlappySession &s) {
+  for (int x = 0; x < FB_WIDTH; ++x) {
+    if (!s.col_touched[x]) continue;
+    s.col_touched[x] = false;
+    for (int y = 0; y < FB_HEIGHT; ++y) {
+      int i = y * FB_WIDTH + x;
+      unsigned char v = (unsigned char)cell_at(s, x, y);
+      if (s.frame[i] == v) continue;
+      s.frame[i] = v;
+      if (s.dirty_count < 0) continue;
+      if (s.dirty_count >= FB_DIRTY_CAP) {
+        s.dirty_count = -1;
+        continue;
+      }
+      s.dirty[s.dirty_count * 2] = i;
+      s.dirty[s.dirty_count * 2 + 1] = v;
+      s.dirty_count++;
+    }
+  }
+}
+
+static void fb_reset(FlappySession &s, uint64_t seed) {
+  s.rng.seed(seed);
+  s.game_over = false;
+  s.started = false; // require first click to start
+  s.score = 0;
+  s.tick = 0;
+  s.bird_y = FB_HEIGHT * FB_FP_ONE / 2; // center bird
+  s.bird_vy = 0;                        // no velocity at start
+  s.prev_bird_y = s.bird_y;
+  s.pending_ms = 0;
+  s.scrolled = false;
+  s.input.clear();
+  s.pipe_head = 0;
+  s.pipe_count = 0;
+  s.scroll = 0;
+  s.course_head = 0;
+  s.course_count = 0;
+  s.course_index = 0;
+  s.course_center = FB_HEIGHT / 2; // the bird starts level with the middle
+  fill_course(s, FB_COURSE_LOOKAHEAD);
 
   // Start with pipes VERY far away to give player lots of time
-  int startX = FB_WIDTH + 20;
+  int64_t x = (int64_t)(FB_WIDTH + 20) * FB_FP_ONE;
   for (int i = 0; i < 3; ++i) {
-    Pipe p;
-    p.x = startX + i * PIPE_SPACING;
-    p.gapY = irand(4, FB_HEIGHT - PIPE_GAP - 4); // more centered gaps
-    pipes.push_back(p);
+    CourseSlot c = take_course(s);
+    if (i > 0) x += c.spacing * FB_FP_ONE;
+    push_pipe(s, x, c.gapY, c.gapH);
   }
+  render_full_frame(s);
+}
+
+// Session handles: flappy_create returns a new id (-1 when the pool is full),
+// flappy_use selects the session every other flappy_* call acts on.
+EMSCRIPTEN_KEEPALIVE int flappy_create() { return fb_sessions.create(); }
+
+EMSCRIPTEN_KEEPALIVE int flappy_destroy(int id) {
+  if (fb_sessions.get(id) == fb) fb = fb_sessions.defaultSession();
+  return fb_sessions.destroy(id) ? 1 : 0;
 }
 
+EMSCRIPTEN_KEEPALIVE int flappy_use(int id) {
+  FlappySession* s = fb_sessions.get(id);
+  if (!s) return 0;
+  fb = s;
+  return 1;
+}
+
+// Seed for the following games; each flappy_start_game() then lays out the
+// same pipes.
+EMSCRIPTEN_KEEPALIVE void flappy_set_seed(uint64_t seed) { fb->seeds.set(seed); }
+
 // Set difficulty: 1=Easy, 2=Normal, 3=Hard
 EMSCRIPTEN_KEEPALIVE void flappy_set_difficulty(int level) {
   if (level == 1) {
-    PIPE_GAP = 10; // Easy
+    fb->pipe_gap = 10; // Easy
   } else if (level == 3) {
-    PIPE_GAP = 7; // Hard
+    fb->pipe_gap = 7; // Hard
   } else {
-    PIPE_GAP = 8; // Normal
+    fb->pipe_gap = 8; // Normal
   }
+  render_full_frame(*fb);
 }
 
 // Public API
 EMSCRIPTEN_KEEPALIVE int flappy_get_width() { return FB_WIDTH; }
 EMSCRIPTEN_KEEPALIVE int flappy_get_height() { return FB_HEIGHT; }
-EMSCRIPTEN_KEEPALIVE int flappy_get_score() { return fb_score; }
-EMSCRIPTEN_KEEPALIVE int flappy_is_game_over() { return fb_game_over ? 1 : 0; }
-EMSCRIPTEN_KEEPALIVE int flappy_has_started() { return fb_started ? 1 : 0; }
-EMSCRIPTEN_KEEPALIVE double flappy_get_bird_y() { return birdYf; }
-
-EMSCRIPTEN_KEEPALIVE void flappy_start_game() { fb_reset(); }
-
-EMSCRIPTEN_KEEPALIVE void flappy_flap() {
-  if (fb_game_over) return;
-  if (!fb_started) {
-    fb_started = true; // start game on first flap
-    birdVyf = -3.1;
+EMSCRIPTEN_KEEPALIVE int flappy_get_score() { return fb->score; }
+EMSCRIPTEN_KEEPALIVE int flappy_is_game_over() { return fb->game_over ? 1 : 0; }
+EMSCRIPTEN_KEEPALIVE int flappy_has_started() { return fb->started ? 1 : 0; }
+EMSCRIPTEN_KEEPALIVE double flappy_get_bird_y() { return fb->bird_y / (double)FB_FP_ONE; }
+
+EMSCRIPTEN_KEEPALIVE void flappy_start_game() {
+  FlappySession &s = *fb;
+  uint64_t seed = s.seeds.take();
+  fb_reset(s, seed);
+  s.replay.begin(FB_REPLAY_TAG, seed, s.pipe_gap, 0);
+}
+
+static void flap(FlappySession &s) {
+  if (s.game_over) return;
+  if (!s.started) {
+    s.started = true; // start game on first flap
+    s.bird_vy = FB_FLAP_VY;
     return;
   }
-  birdVyf = -3.1;
+  s.bird_vy = FB_FLAP_VY;
 }
 
-static void add_pipe_right() {
-  int maxRight = FB_WIDTH;
-  for (const auto &p : pipes) if (p.x > maxRight) maxRight = p.x;
-  Pipe np;
-  np.x = maxRight + PIPE_SPACING;
-  np.gapY = irand(4, FB_HEIGHT - PIPE_GAP - 4);
-  pipes.push_back(np);
-}
+// The session's input ring (see InputRing.h); JS writes INPUT_FLAP events
+// into it directly and they apply at the next step
+EMSCRIPTEN_KEEPALIVE InputRing* flappy_input_ptr() { return &fb->input; }
 
-static void update_physics() {
-  if (fb_game_over || !fb_started) return;
+// Queues one flap, for callers without access to the ring
+EMSCRIPTEN_KEEPALIVE void flappy_flap() { fb->input.push(INPUT_FLAP, 0); }
 
-  // Gravity (small acceleration each tick, reduced for smoother motion)
-  birdVyf += 0.24;
-  // Cap velocities
-  if (birdVyf > 3.9) birdVyf = 3.9;
-  if (birdVyf < -4.5) birdVyf = -4.5;
+static void add_pipe_right(FlappySession &s) {
+  int64_t maxRight = s.scroll + FB_WIDTH * FB_FP_ONE;
+  if (s.pipe_count > 0 && s.rightmost_x > maxRight) maxRight = s.rightmost_x;
+  CourseSlot c = take_course(s);
+  push_pipe(s, maxRight + c.spacing * FB_FP_ONE, c.gapY, c.gapH);
+}
+
+static void update_physics(FlappySession &s) {
+  if (s.game_over || !s.started) return;
 
-  // Integrate position with a small factor for smoother motion on coarse grids
-  birdYf += birdVyf * 0.28;
+  // Gravity, capped velocities, then integrate
+  s.bird_vy += FB_GRAVITY;
+  if (s.bird_vy > FB_MAX_FALL_VY) s.bird_vy = FB_MAX_FALL_VY;
+  if (s.bird_vy < FB_MAX_RISE_VY) s.bird_vy = FB_MAX_RISE_VY;
+  s.bird_y += s.bird_vy;
+  if (s.bird_y < FB_CEILING_Y) {
+    s.bird_y = FB_CEILING_Y;
+    s.bird_vy = 0;
+  }
 
-  int birdY = (int)(birdYf + 0.5);
+  int birdY = bird_row(s);
 
   // bounds check
   // Allow flying above the screen without instant loss; ground is still a loss
   if (birdY >= FB_HEIGHT) {
-    fb_game_over = true;
+    s.game_over = true;
     return;
   }
 
-  // Pipe movement (moderate speed)
-  bool movedThisTick = (fb_tick % 5) == 0;
-  if (movedThisTick) {
-    for (auto &p : pipes) p.x -= 1;
-  }
+  // Pipes scroll a fraction of a cell every step
+  s.scroll += FB_PIPE_SPEED;
+  s.scrolled = true;
 
   // remove off-screen pipes and add new ones
-  if (!pipes.empty() && pipes.front().x < -1) {
-    pipes.erase(pipes.begin());
+  if (s.pipe_count > 0 && fp_cell(screen_x(s, pipe_at(s, 0))) < -1) {
+    pop_pipe(s);
   }
-  if (pipes.empty() || pipes.back().x < FB_WIDTH) {
-    add_pipe_right();
+  if (s.pipe_count == 0 || fp_cell((int32_t)(s.rightmost_x - s.scroll)) < FB_WIDTH) {
+    add_pipe_right(s);
   }
 
-  // collision and scoring: check pipe at bird column
-  for (const auto &p : pipes) {
-    if (p.x == BIRD_X) {
+  // collision and scoring: check pipes up to the bird column
+  for (int i = 0; i < s.pipe_count; ++i) {
+    const Pipe &p = pipe_at(s, i);
+    int32_t x = screen_x(s, p);
+    int col = fp_cell(x);
+    if (col > BIRD_X) break;
+    if (col == BIRD_X) {
       // in pipe column; collide if outside gap
       // Only check collision when the bird is within visible board height
       if (birdY >= 0 && birdY < FB_HEIGHT) {
-        if (birdY < p.gapY || birdY >= p.gapY + PIPE_GAP) {
-          fb_game_over = true;
+        if (birdY < p.gapY || birdY >= p.gapY + p.gapH) {
+          s.game_over = true;
           return;
         }
       }
     }
-    if (p.x == BIRD_X - 1 && movedThisTick) {
-      // passed a pipe
-      fb_score += 1;
+    if (col == BIRD_X - 1 && fp_cell(x + FB_PIPE_SPEED) == BIRD_X) {
+      // passed a pipe this step
+      s.score += 1;
     }
   }
 }
 
-EMSCRIPTEN_KEEPALIVE int flappy_tick() {
-  if (fb_game_over) return 0;
-  fb_tick += 1;
-  update_physics();
-  return fb_game_over ? 0 : 1;
+// render=false is replay fast-forward: flaps come from the loaded log only
+// (the input ring and the log are left alone) and the column diff is
+// skipped; call render_full_frame() afterwards.
+static int step(FlappySession &s, bool render) {
+  if (s.game_over) return 0;
+  // Flaps from a loaded replay that are due before this tick
+  s.replay.applyDue(s.tick, [&s](int input) { if (input == FB_INPUT_FLAP) flap(s); });
+  // Live flaps since the last step; several within one step are one flap
+  bool flapped = false;
+  if (render) {
+    s.input.drain([&flapped](const InputEvent &e) {
+      flapped = flapped || e.code == INPUT_FLAP;
+      return true;
+    });
+  }
+  if (flapped) {
+    s.replay.record(s.tick, FB_INPUT_FLAP);
+    flap(s);
+  }
+  s.tick += 1;
+  s.prev_bird_y = s.bird_y;
+  s.scrolled = false;
+  if (render) touch_entity_columns(s);
+  update_physics(s);
+  fill_course(s, FB_COURSE_PER_STEP);
+  if (render) {
+    touch_entity_columns(s);
+    diff_touched_columns(s);
+    export_entities(s);
+  }
+  return s.game_over ? 0 : 1;
 }
 
+EMSCRIPTEN_KEEPALIVE int flappy_tick() { return step(*fb, true); }
+
 EMSCRIPTEN_KEEPALIVE int flappy_update() { return flappy_tick(); }
 
+// Frame-driven stepping: adds elapsed_ms of real time (at most
+// FB_MAX_ADVANCE_MS per call), runs as many fixed steps as it covers and
+// carries the rest. Returns how far the frame lies into the next step, 0..1,
+// for flappy_get_render_bird_y(); 1 once the game is over.
+EMSCRIPTEN_KEEPALIVE double flappy_advance(double elapsed_ms) {
+  FlappySession &s = *fb;
+  if (elapsed_ms > 0) s.pending_ms += elapsed_ms < FB_MAX_ADVANCE_MS ? elapsed_ms : FB_MAX_ADVANCE_MS;
+  while (s.pending_ms >= FB_STEP_MS && !s.game_over) {
+    s.pending_ms -= FB_STEP_MS;
+    step(s, true);
+  }
+  if (s.game_over) {
+    s.pending_ms = 0;
+    return 1.0;
+  }
+  return s.pending_ms / FB_STEP_MS;
+}
+
+// Bird y in cells blended between the last two steps
+EMSCRIPTEN_KEEPALIVE double flappy_get_render_bird_y(double alpha) {
+  const FlappySession &s = *fb;
+  return (s.prev_bird_y + (s.bird_y - s.prev_bird_y) * alpha) / FB_FP_ONE;
+}
+
+// Cells to add to every exported pipe x to draw it at alpha (pipes all
+// scroll together, so one offset covers them)
+EMSCRIPTEN_KEEPALIVE double flappy_get_render_scroll(double alpha) {
+  return fb->scrolled ? (1.0 - alpha) * FB_PIPE_SPEED / FB_FP_ONE : 0.0;
+}
+
+// The entity export (see FB_ENTITY_HEADER), as int32s in WASM memory
+EMSCRIPTEN_KEEPALIVE int32_t* flappy_get_entities_ptr() { return fb->entities; }
+EMSCRIPTEN_KEEPALIVE int flappy_get_fp_one() { return FB_FP_ONE; }
+
+// Back to tick 0 of the session's log: same gap, seed and flaps
+static void restart_replay(FlappySession &s) {
+  s.pipe_gap = s.replay.param(0);
+  fb_reset(s, s.replay.seed());
+  s.replay.rewind();
+}
+
+// The current game's input log, as bytes in WASM memory
+EMSCRIPTEN_KEEPALIVE const int32_t* flappy_replay_get_ptr() { return fb->replay.data(); }
+EMSCRIPTEN_KEEPALIVE int flappy_replay_get_size() { return fb->replay.bytes(); }
+
+// Load a log from flappy_replay_get_ptr/size (copied) and restart its game at
+// tick 0. Returns 1, or 0 if the log is invalid.
+EMSCRIPTEN_KEEPALIVE int flappy_replay_load(const void* ptr, int len) {
+  ReplayLog log;
+  if (!log.load(ptr, len, FB_REPLAY_TAG)) return 0;
+  if (log.param(0) < 7 || log.param(0) > 10) return 0;
+  fb->replay = std::move(log); // keeps the reserved capacity
+  restart_replay(*fb);
+  return 1;
+}
+
+// Re-simulate the log up to `tick` (rewinding first if it lies behind),
+// redrawing once at the end. Returns the tick reached, which is earlier if
+// the game ended.
+EMSCRIPTEN_KEEPALIVE int flappy_replay_seek(int tick) {
+  FlappySession &s = *fb;
+  if (s.replay.empty()) return -1;
+  // Inputs queued for the position being left behind would cut the log here
+  s.input.clear();
+  if (tick < s.tick) restart_replay(s);
+  while (s.tick < tick && step(s, false)) {}
+  render_full_frame(s);
+  return s.tick;
+}
+
+static int write_snapshot(const FlappySession &s, void* out) {
+  SnapshotWriter w(out);
+  FlappySnapshot st = {s.pipe_gap, s.game_over ? 1 : 0, s.started ? 1 : 0, s.score, s.tick,
+                       s.bird_y, s.bird_vy, s.pipe_count,
+                       s.course_index, s.course_center, s.course_count};
+  w.put(FB_SNAPSHOT_TAG);
+  w.put(st);
+  w.put(s.rng);
+  w.put(s.seeds);
+  for (int i = 0; i < s.pipe_count; ++i) {
+    const Pipe &p = pipe_at(s, i);
+    w.put(screen_x(s, p));
+    w.put((int16_t)p.gapY);
+    w.put((int16_t)p.gapH);
+  }
+  for (int i = 0; i < s.course_count; ++i) w.put(s.course[(s.course_head + i) & (FB_COURSE_LOOKAHEAD - 1)]);
+  return w.written();
+}
+
+// Binary save state of the current session (see FlappySnapshot). JS allocates
+// flappy_snapshot_size() bytes; flappy_snapshot writes them and returns the count.
+EMSCRIPTEN_KEEPALIVE int flappy_snapshot_size() { return write_snapshot(*fb, nullptr); }
+EMSCRIPTEN_KEEPALIVE int flappy_snapshot(void* ptr) { return ptr ? write_snapshot(*fb, ptr) : 0; }
+
+// Replace the current session's game with a snapshot. Returns 1, or 0 (and
+// leaves the session alone) if the blob is invalid. Clears the replay log.
+EMSCRIPTEN_KEEPALIVE int flappy_restore(const void* ptr, int len) {
+  SnapshotReader in(ptr, len);
+  uint32_t tag = 0;
+  FlappySnapshot st;
+  Rng rng;
+  SeedChain seeds;
+  if (!in.get(tag) || tag != FB_SNAPSHOT_TAG || !in.get(st) || !in.get(rng) || !in.get(seeds)) return 0;
+  if (st.pipe_gap < 7 || st.pipe_gap > 10 || st.pipe_count < 0 || st.pipe_count > FB_PIPE_CAPACITY) return 0;
+  if (st.course_count < 0 || st.course_count > FB_COURSE_LOOKAHEAD || st.course_index < 0) return 0;
+  // The bird stays below the ceiling and falls at most one step past the ground
+  if (st.bird_y < FB_CEILING_Y || st.bird_y > FB_HEIGHT * FB_FP_ONE + FB_MAX_FALL_VY) return 0;
+  if (st.bird_vy < FB_MAX_RISE_VY || st.bird_vy > FB_MAX_FALL_VY) return 0;
+  const unsigned char* pipeData = in.view(st.pipe_count * 8);
+  CourseSlot course[FB_COURSE_LOOKAHEAD];
+  if (!in.bytes(course, st.course_count * (int)sizeof(CourseSlot)) || !in.done()) return 0;
+  for (int i = 0; i < st.course_count; ++i) {
+    if (course[i].spacing < 1 || course[i].gapY < 0 || course[i].gapH < 1 || course[i].gapY + course[i].gapH > FB_HEIGHT) return 0;
+  }
+  // Pipes must be in the ring's left-to-right order with gaps on the board
+  for (int i = 0; i < st.pipe_count; ++i) {
+    int32_t x, prevX = 0;
+    int16_t gap[2];
+    memcpy(&x, pipeData + 8 * i, 4);
+    memcpy(gap, pipeData + 8 * i + 4, 4);
+    if (i > 0) memcpy(&prevX, pipeData + 8 * (i - 1), 4);
+    if (gap[0] < 0 || gap[1] < 1 || gap[0] + gap[1] > FB_HEIGHT || (i > 0 && x <= prevX)) return 0;
+  }
+
+  FlappySession &s = *fb;
+  s.pipe_gap = st.pipe_gap;
+  s.game_over = st.game_over != 0;
+  s.started = st.started != 0;
+  s.input.clear();
+  s.score = st.score;
+  s.tick = st.tick;
+  s.bird_y = st.bird_y;
+  s.bird_vy = st.bird_vy;
+  s.prev_bird_y = st.bird_y;
+  s.pending_ms = 0;
+  s.scrolled = false;
+  s.rng = rng;
+  s.seeds = seeds;
+  s.pipe_head = 0;
+  s.pipe_count = 0;
+  s.scroll = 0;
+  for (int i = 0; i < st.pipe_count; ++i) {
+    int32_t x;
+    int16_t gap[2];
+    memcpy(&x, pipeData + 8 * i, 4);
+    memcpy(gap, pipeData + 8 * i + 4, 4);
+    push_pipe(s, x, gap[0], gap[1]);
+  }
+  s.course_head = 0;
+  s.course_count = st.course_count;
+  s.course_index = st.course_index;
+  s.course_center = st.course_center;
+  memcpy(s.course, course, st.course_count * sizeof(CourseSlot));
+  s.replay.clear();
+  render_full_frame(s);
+  return 1;
+}
+
 // Return board content as character code for flattened index
 EMSCRIPTEN_KEEPALIVE int flappy_get_cell(int index) {
   if (index < 0) return 0;
@@ -171,25 +654,12 @@ EMSCRIPTEN_KEEPALIVE int flappy_get_cell(int index) {
   int x = index % w;
   int y = index / w;
   if (y < 0 || y >= h) return 0;
-
-  // bird
-  {
-    int birdY = (int)(birdYf + 0.5);
-    if (x == BIRD_X && y == birdY) return 'B';
-  }
-
-  // pipes
-  for (const auto &p : pipes) {
-    if (p.x == x) {
-      if (y < p.gapY || y >= p.gapY + PIPE_GAP) return '#';
-      break;
-    }
-  }
-
-  // background
-  return ' ';
+  return cell_at(*fb, x, y);
 }
 
-} 
+EMSCRIPTEN_KEEPALIVE int flappy_get_dirty_count() { return fb->dirty_count; }
+EMSCRIPTEN_KEEPALIVE int* flappy_get_dirty_ptr() { return fb->dirty; }
+EMSCRIPTEN_KEEPALIVE void flappy_clear_dirty() { fb->dirty_count = 0; }
 
+}
 
@@ -1,6 +1,9 @@
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
-#include <stdlib.h>
-#include <time.h>
+#else
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#include "Rng.h"
 
 static double absd(double v) { return v < 0.0 ? -v : v; }
 
@@ -9,6 +12,8 @@ extern "C" {
     static int attempts = 0;
     static int max_number_global = 100;
     static int hint_difficulty = 1; // 0 easy, 1 normal, 2 hard
+    static Rng rng;
+    static SeedChain seeds;
 
     static int hint_code_from_guess(int guess) {
         if (guess == secret_number) return 0;
@@ -41,35 +46,41 @@ extern "C" {
         return magnitude;
     }
 
+    // Seed for the following games; guess_start_game() then picks the same numbers
     EMSCRIPTEN_KEEPALIVE
-    void start_game(int max_number) {
-        srand((unsigned int)time(NULL));
+    void guess_set_seed(uint64_t seed) {
+        seeds.set(seed);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void guess_start_game(int max_number) {
+        rng.seed(seeds.take());
         max_number_global = max_number;
-        secret_number = rand() % max_number + 1;
+        secret_number = rng.below(max_number) + 1;
         attempts = 0;
     }
 
     EMSCRIPTEN_KEEPALIVE
-    void set_hint_difficulty(int level) {
+    void guess_set_hint_difficulty(int level) {
         if (level < 0) level = 0;
         if (level > 2) level = 2;
         hint_difficulty = level;
     }
 
     EMSCRIPTEN_KEEPALIVE
-    int make_guess(int guess) {
+    int guess_make_guess(int guess) {
         attempts++;
         return guess - secret_number;
     }
 
     EMSCRIPTEN_KEEPALIVE
-    int make_guess_hint(int guess) {
+    int guess_make_guess_hint(int guess) {
         attempts++;
         return hint_code_from_guess(guess);
     }
 
     EMSCRIPTEN_KEEPALIVE
-    int get_attempts() {
+    int guess_get_attempts() {
         return attempts;
     }
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+
+// Timestamped input events for one real-time session, written by JS straight
+// into WASM memory and drained by the engine at tick boundaries, so a burst of
+// inputs costs no calls and each game decides how events within one tick
+// combine.
+//
+// Single producer (JS, or the *_set_direction/flappy_flap wrappers for native
+// callers), single consumer (the engine). head and tail are free-running
+// counters: the producer only ever stores head, the consumer only tail.
+//
+// Layout, found through *_input_ptr() and addressed by byte offset:
+//   +0   uint32 head      next event the producer writes
+//   +4   uint32 tail      next event the consumer reads
+//   +8   uint32 capacity  power of two
+//   +12  uint32 reserved
+//   +16  events[capacity], 16 bytes each: float64 time_ms, int32 code, int32 value
+// The producer fills events[head & (capacity - 1)], then stores head + 1; it
+// must not write while head - tail == capacity.
+
+// Event codes (value in parentheses)
+static const int32_t INPUT_DIRECTION = 1; // (0=Up, 1=Right, 2=Down, 3=Left)
+static const int32_t INPUT_FLAP = 2;      // (unused)
+
+struct InputEvent {
+  double time_ms; // when the player gave the input; informational for the engine
+  int32_t code;
+  int32_t value;
+};
+
+class InputRing {
+public:
+  static const uint32_t CAPACITY = 64;
+
+  // Producer side. False (event dropped) when the ring is full.
+  bool push(int32_t code, int32_t value, double time_ms = 0) {
+    const uint32_t h = head;
+    if (h - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) >= CAPACITY) return false;
+    InputEvent &e = events[h & (CAPACITY - 1)];
+    e.time_ms = time_ms;
+    e.code = code;
+    e.value = value;
+    __atomic_store_n(&head, h + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  // Consumer side: hands pending events to apply, oldest first, until it
+  // returns false (that event is consumed, later ones stay queued). Returns
+  // how many events were consumed.
+  template <typename Apply>
+  int drain(Apply apply) {
+    const uint32_t h = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+    uint32_t t = tail;
+    int n = 0;
+    while (t != h) {
+      const InputEvent e = events[t & (CAPACITY - 1)];
+      ++t;
+      ++n;
+      if (!apply(e)) break;
+    }
+    __atomic_store_n(&tail, t, __ATOMIC_RELEASE);
+    return n;
+  }
+
+  // Consumer side: drops everything queued, e.g. inputs aimed at a game that
+  // was just restarted or replaced
+  void clear() { __atomic_store_n(&tail, __atomic_load_n(&head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE); }
+
+  int pending() const {
+    return (int)(__atomic_load_n(&head, __ATOMIC_ACQUIRE) - __atomic_load_n(&tail, __ATOMIC_ACQUIRE));
+  }
+
+private:
+  uint32_t head = 0;
+  uint32_t tail = 0;
+  uint32_t capacity = CAPACITY; // read by JS
+  uint32_t reserved = 0;
+  InputEvent events[CAPACITY] = {};
+};
+
+static_assert(sizeof(InputEvent) == 16, "JS addresses events with a 16-byte stride");
+static_assert(sizeof(InputRing) == 16 + 16 * InputRing::CAPACITY, "JS relies on the documented layout");
+static_assert((InputRing::CAPACITY & (InputRing::CAPACITY - 1)) == 0, "capacity must be a power of two");
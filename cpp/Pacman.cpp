@@ -1,7 +1,15 @@
-#include <vector>
 #include <cstdlib>
-#include <ctime>
-#include <algorithm>
+#include <cstring>
+#include <utility>
+#include "InputRing.h"
+#include "Replay.h"
+#include "Rng.h"
+#include "SessionPool.h"
+#include "Snapshot.h"
+#include "Tiles.h"
+#ifdef PACMAN_DEBUG_ALLOCS
+#include <new>
+#endif
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
@@ -13,390 +21,781 @@
 namespace {
   const int BOARD_WIDTH = 28;
   const int BOARD_HEIGHT = 31;
+  const int BOARD_SIZE = BOARD_WIDTH * BOARD_HEIGHT;
+  const int MAX_GHOSTS = 32;
+  const int32_t REPLAY_TAG = 0x314E4350; // "PCN1"; params are ghost count, level
+
+  // pacman_snapshot layout: tag, PacmanSnapshot, tickCount (int64), Rng,
+  // SeedChain, ghostCount ghosts as 7 int32 each (Ghost field order), then the
+  // base map as 2-bit tile codes.
+  const uint32_t SNAPSHOT_TAG = 0x53434150; // "PACS"
+  struct PacmanSnapshot {
+    int32_t pacmanX, pacmanY, pacmanDir, pacmanPendingDir;
+    int32_t ghostCount, requestedGhostCount, ghostSpeed;
+    int32_t score, pelletsRemaining, gameOver, gameWon, frightenedTimer;
+  };
+  const char TILE_CODES[4] = {' ', '.', 'o', '#'};
+
+  // Frame character to renderer tile id (see Tiles.h)
+  struct TileTable {
+    unsigned char ids[256] = {};
+    TileTable() {
+      ids['#'] = TILE_WALL;
+      ids['.'] = TILE_PELLET;
+      ids['o'] = TILE_POWER_PELLET;
+      ids['P'] = TILE_PACMAN;
+      ids['G'] = TILE_GHOST;
+    }
+    unsigned char operator[](unsigned char c) const { return ids[c]; }
+  };
+  const TileTable TILE_OF;
 
-  // Base map without dynamic entities. '#' wall, '.' pellet, 'o' power pellet, ' ' empty
-  std::vector<char> baseBoard(BOARD_WIDTH * BOARD_HEIGHT, ' ');
-
-  int pacmanX = 13;
-  int pacmanY = 23;
-  int pacmanDir = 1; // 0 Up, 1 Right, 2 Down, 3 Left
-  int pacmanPendingDir = -1; // buffered desired direction
+  // All engine storage is fixed-capacity: sessions live in pooled slabs and
+  // nothing touches the heap during play (see pacman_debug_get_alloc_count).
 
-  struct Ghost { int x; int y; int dir; int scatterX; int scatterY; bool released; int releaseTick; };
-  std::vector<Ghost> ghosts;
+  // Frame cells changed since the last pacman_clear_dirty(), as (index, value) pairs.
+  // dirtyCount == -1 means the list overflowed and the whole frame must be re-read.
+  const int DIRTY_CAP = 128;
 
-  int score = 0;
-  bool gameOver = false;
-  bool gameWon = false;
-  int frightenedTimer = 0; // global frightened duration for simplicity
-  long long tickCount = 0;
-  int ghostSpeed = 1; // ticks per move, lower is faster
+  const int FRIGHTENED_TICKS = 80; // how long a power pellet frightens the ghosts
 
   inline int idx(int x, int y) { return y * BOARD_WIDTH + x; }
 
-  bool isWall(int x, int y) {
-    if (x < 0 || y < 0 || x >= BOARD_WIDTH || y >= BOARD_HEIGHT) return true;
-    return baseBoard[idx(x, y)] == '#';
-  }
+  struct Ghost { int x; int y; int dir; int scatterX; int scatterY; bool released; int releaseTick; };
 
-  void seedMap() {
-    // Approximate 28x31 classic maze. Each string must be width 28.
-    // Using simple straight segments to keep pathfinding performant.
-    static const char* MAP[BOARD_HEIGHT] = {
-      "############################",
-      "#............##............#",
-      "#.####.#####.##.#####.####.#",
-      "#o####.#####.##.#####.####o#",
-      "#.####.#####.##.#####.####.#",
-      "#..........................#",
-      "#.####.##.########.##.####.#",
-      "#.####.##.########.##.####.#",
-      "#......##....##....##......#",
-      "######.##### ## #####.######",
-      "######.##### ## #####.######",
-      "######.##          ##.######",
-      "######.## ###GG### ##.######",
-      "      .   #      #   .      ",
-      "######.## # #### # ##.######",
-      "######.## #      # ##.######",
-      "######.## ######## ##.######",
-      "#............##............#",
-      "#.####.#####.##.#####.####.#",
-      "#.####.#####.##.#####.####.#",
-      "#o..##................##..o#",
-      "###.##.##.########.##.##.###",
-      "###.##.##.########.##.##.###",
-      "#......##....##....##......#",
-      "#.##########.##.##########.#",
-      "#..........................#",
-      "#.##########.##.##########.#",
-      "#..........................#",
-      "############################",
-      "############################",
-      "############################",
-    };
-
-    for (int y = 0; y < BOARD_HEIGHT; ++y) {
-      for (int x = 0; x < BOARD_WIDTH; ++x) {
-        char c = MAP[y][x];
-        if (c == 'G') c = ' '; // ghosts are dynamic, leave path
-        baseBoard[idx(x, y)] = c;
-      }
-    }
-  }
+  // Scratch for the BFS helpers below. Entries are valid when visitStamp[id] ==
+  // visitEpoch, so each search starts by bumping the epoch instead of clearing.
+  int visitStamp[BOARD_SIZE];
+  int visitEpoch = 0;
+  int bfsQueue[BOARD_SIZE];
 
-  // Basic connectivity check to ensure Pacman can reach pellets
-  bool mapIsReachableFrom(int sx, int sy) {
-    std::vector<int> vis(BOARD_WIDTH * BOARD_HEIGHT, 0);
-    std::vector<int> q;
-    auto push = [&](int x, int y){ int id = idx(x,y); if (!vis[id]) { vis[id]=1; q.push_back(id);} };
-    if (isWall(sx, sy)) return false;
-    push(sx, sy);
-    size_t qi = 0;
-    const int dx[4] = {0,1,0,-1};
-    const int dy[4] = {-1,0,1,0};
-    while (qi < q.size()) {
-      int id0 = q[qi++];
-      int x = id0 % BOARD_WIDTH; int y = id0 / BOARD_WIDTH;
-      for (int d = 0; d < 4; ++d) {
-        int nx = x + dx[d]; int ny = y + dy[d];
-        if (nx < 0 || ny < 0 || nx >= BOARD_WIDTH || ny >= BOARD_HEIGHT) continue;
-        if (isWall(nx, ny)) continue;
-        push(nx, ny);
-      }
+  void beginVisit() {
+    if (++visitEpoch == 0) {
+      for (int i = 0; i < BOARD_SIZE; ++i) visitStamp[i] = 0;
+      visitEpoch = 1;
     }
-    // Ensure all pellets are in visited area
-    for (int y = 0; y < BOARD_HEIGHT; ++y) {
-      for (int x = 0; x < BOARD_WIDTH; ++x) {
-        char c = baseBoard[idx(x,y)];
-        if ((c == '.' || c == 'o') && !vis[idx(x,y)]) return false;
-      }
-    }
-    return true;
   }
 
-  void resetGame(int /*level*/ = 1) {
-    // Lite mode: fixed single map for predictable gameplay quality.
-    seedMap();
-    pacmanX = 13; pacmanY = 23; pacmanDir = 1;
-    pacmanPendingDir = -1;
-    ghosts.clear();
-    ghostSpeed = 2;
-    ghosts.push_back({13, 12, 0, BOARD_WIDTH - 2, 1, false, 60});
-    ghosts.push_back({14, 12, 1, 1, 1, false, 120});
-    ghosts.push_back({12, 12, 2, 1, BOARD_HEIGHT - 2, false, 180});
-    ghosts.push_back({15, 12, 3, BOARD_WIDTH - 2, BOARD_HEIGHT - 2, false, 240});
-    score = 0;
-    gameOver = false;
-    gameWon = false;
-    frightenedTimer = 0;
-    tickCount = 0;
-    std::srand((unsigned int)time(NULL));
+  // Navigation table, rebuilt per map load. Walkable tiles get compact ids, and
+  // navNext packs (2 bits each) the first step from every walkable tile toward
+  // every other one, so ghost targeting is a single lookup per decision.
+  int walkId[BOARD_SIZE];       // by cell, -1 for walls
+  int walkCell[BOARD_SIZE];     // by walk id
+  int walkComponent[BOARD_SIZE]; // by walk id; unequal components are unreachable
+  int nearestWalkCell[BOARD_SIZE]; // by cell, closest walkable cell (for wall targets)
+  int walkCount = 0;
+  bool navReady = false; // MAP walls never change, so one build serves every game
+  unsigned char navNext[(BOARD_SIZE * BOARD_SIZE + 3) / 4];
+
+  const int DIR_DX[4] = {0, 1, 0, -1};
+  const int DIR_DY[4] = {-1, 0, 1, 0};
+
+  inline void navSet(int from, int to, int dir) {
+    int k = from * walkCount + to;
+    int shift = (k & 3) * 2;
+    navNext[k >> 2] = (unsigned char)((navNext[k >> 2] & ~(3 << shift)) | (dir << shift));
   }
 
-  bool canMove(int x, int y, int dir) {
-    int nx = x, ny = y;
-    if (dir == 0) ny -= 1; else if (dir == 1) nx += 1; else if (dir == 2) ny += 1; else if (dir == 3) nx -= 1;
-    return !isWall(nx, ny);
+  inline int navGet(int from, int to) {
+    int k = from * walkCount + to;
+    return (navNext[k >> 2] >> ((k & 3) * 2)) & 3;
   }
 
-  bool moveIfFree(int &x, int &y, int dir) {
-    int nx = x, ny = y;
-    if (dir == 0) ny -= 1; else if (dir == 1) nx += 1; else if (dir == 2) ny += 1; else if (dir == 3) nx -= 1;
-    if (!isWall(nx, ny)) { x = nx; y = ny; return true; }
-    return false;
+  // First step from (x, y) toward tile (tx, ty), or -1 if already there,
+  // off the walkable graph, or unreachable.
+  int navDirToward(int x, int y, int tx, int ty) {
+    int from = walkId[idx(x, y)];
+    int to = walkId[nearestWalkCell[idx(tx, ty)]];
+    if (from < 0 || from == to || walkComponent[from] != walkComponent[to]) return -1;
+    return navGet(from, to);
   }
 
-  void stepPacman() {
-    // Apply buffered turn if available and possible from current tile
-    if (pacmanPendingDir != -1 && canMove(pacmanX, pacmanY, pacmanPendingDir)) {
-      pacmanDir = pacmanPendingDir;
-      pacmanPendingDir = -1;
+  int clamp(int v, int lo, int hi) { if (v < lo) return lo; if (v > hi) return hi; return v; }
+
+  // Alternating scatter/chase phase lengths in ticks, starting with scatter;
+  // chase continues indefinitely once the schedule runs out.
+  const int MODE_SCHEDULE[] = {70, 200, 70, 200, 50, 200, 50};
+
+  // Heap allocations since the last pacman_start_game. Only counted when built
+  // with -DPACMAN_DEBUG_ALLOCS, which routes global operator new through here.
+  long long heapAllocCount = 0;
+
+  // One game. The walls never differ between sessions, so the navigation table
+  // and BFS scratch above are shared; everything a tick mutates lives here.
+  struct Session {
+    // Base map without dynamic entities. '#' wall, '.' pellet, 'o' power pellet, ' ' empty
+    char baseBoard[BOARD_SIZE] = {};
+
+    int pacmanX = 13;
+    int pacmanY = 23;
+    int pacmanDir = 1; // 0 Up, 1 Right, 2 Down, 3 Left
+    int pacmanPendingDir = -1; // buffered desired direction
+
+    // Direction inputs from JS, drained at the start of every tick
+    InputRing input;
+
+    Ghost ghosts[MAX_GHOSTS] = {};
+    int ghostCount = 0;
+    int requestedGhostCount = 4; // applied on the next pacman_start_game
+
+    int score = 0;
+    int pelletsRemaining = 0; // '.' and 'o' left on baseBoard, maintained incrementally
+    bool gameOver = false;
+    bool gameWon = false;
+    int frightenedTimer = 0; // global frightened duration for simplicity
+    long long tickCount = 0;
+    int ghostSpeed = 1; // ticks per move, lower is faster
+
+    // Frightened-ghost wandering; reseeded by every resetGame()
+    Rng rng;
+    SeedChain seeds;
+
+    // This game's seed and direction inputs, keyed by tickCount (see Replay.h)
+    ReplayLog replay;
+
+    // Composed frame (base tiles + Pacman/ghost overlays), read by JS via HEAPU8
+    unsigned char frameBuf[BOARD_SIZE] = {};
+    // The same frame as tile ids for the renderer (see Tiles.h)
+    unsigned char tileBuf[BOARD_SIZE] = {};
+
+    int dirtyCells[DIRTY_CAP * 2] = {};
+    int dirtyCount = -1;
+
+    bool isWall(int x, int y) {
+      if (x < 0 || y < 0 || x >= BOARD_WIDTH || y >= BOARD_HEIGHT) return true;
+      return baseBoard[idx(x, y)] == '#';
     }
-    if (moveIfFree(pacmanX, pacmanY, pacmanDir)) {
-      char &cell = baseBoard[idx(pacmanX, pacmanY)];
-      if (cell == '.') { cell = ' '; score += 10; }
-      else if (cell == 'o') { cell = ' '; score += 50; frightenedTimer = 80; }
+
+    void seedMap() {
+      // Approximate 28x31 classic maze. Each string must be width 28.
+      // Using simple straight segments to keep pathfinding performant.
+      static const char* MAP[BOARD_HEIGHT] = {
+        "############################",
+        "#............##............#",
+        "#.####.#####.##.#####.####.#",
+        "#o####.#####.##.#####.####o#",
+        "#.####.#####.##.#####.####.#",
+        "#..........................#",
+        "#.####.##.########.##.####.#",
+        "#.####.##.########.##.####.#",
+        "#......##....##....##......#",
+        "######.##### ## #####.######",
+        "######.##### ## #####.######",
+        "######.##          ##.######",
+        "######.## ###GG### ##.######",
+        "      .   #      #   .      ",
+        "######.## # #### # ##.######",
+        "######.## #      # ##.######",
+        "######.## ######## ##.######",
+        "#............##............#",
+        "#.####.#####.##.#####.####.#",
+        "#.####.#####.##.#####.####.#",
+        "#o..##................##..o#",
+        "###.##.##.########.##.##.###",
+        "###.##.##.########.##.##.###",
+        "#......##....##....##......#",
+        "#.##########.##.##########.#",
+        "#..........................#",
+        "#.##########.##.##########.#",
+        "#..........................#",
+        "############################",
+        "############################",
+        "############################",
+      };
+
+      pelletsRemaining = 0;
+      for (int y = 0; y < BOARD_HEIGHT; ++y) {
+        for (int x = 0; x < BOARD_WIDTH; ++x) {
+          char c = MAP[y][x];
+          if (c == 'G') c = ' '; // ghosts are dynamic, leave path
+          if (c == '.' || c == 'o') ++pelletsRemaining;
+          baseBoard[idx(x, y)] = c;
+        }
+      }
     }
-  }
 
-  int randomDirExcept(int except) {
-    int d = std::rand() % 4;
-    if (d == except) d = (d + 1) % 4;
-    return d;
-  }
+    // Fills the shared navigation table from this session's walls.
+    void buildNavigation() {
+      walkCount = 0;
+      for (int i = 0; i < BOARD_SIZE; ++i) {
+        if (baseBoard[i] == '#') { walkId[i] = -1; continue; }
+        walkId[i] = walkCount;
+        walkCell[walkCount] = i;
+        walkComponent[walkCount] = -1;
+        ++walkCount;
+      }
+
+      // One BFS per target tile. Reaching n from c means the first step from n
+      // toward the target is the reverse of the direction we travelled.
+      int components = 0;
+      for (int t = 0; t < walkCount; ++t) {
+        bool newComponent = walkComponent[t] < 0;
+        beginVisit();
+        int qn = 0, qi = 0;
+        visitStamp[walkCell[t]] = visitEpoch;
+        bfsQueue[qn++] = walkCell[t];
+        while (qi < qn) {
+          int c = bfsQueue[qi++];
+          if (newComponent) walkComponent[walkId[c]] = components;
+          int cx = c % BOARD_WIDTH, cy = c / BOARD_WIDTH;
+          for (int d = 0; d < 4; ++d) {
+            int nx = cx + DIR_DX[d], ny = cy + DIR_DY[d];
+            if (isWall(nx, ny)) continue;
+            int n = idx(nx, ny);
+            if (visitStamp[n] == visitEpoch) continue;
+            visitStamp[n] = visitEpoch;
+            navSet(walkId[n], t, (d + 2) % 4);
+            bfsQueue[qn++] = n;
+          }
+        }
+        if (newComponent) ++components;
+      }
 
-  struct Node { int x; int y; int px; int py; };
-
-  bool passable(int x, int y) { return !isWall(x, y); }
-
-  int bfsNextDir(int sx, int sy, int tx, int ty, int forbidDir) {
-    if (sx == tx && sy == ty) return forbidDir == 0 ? 0 : (forbidDir == 1 ? 1 : (forbidDir == 2 ? 2 : 3));
-    const int size = BOARD_WIDTH * BOARD_HEIGHT;
-    std::vector<int> visited(size, 0);
-    std::vector<Node> parent(size, {-1,-1,-1,-1});
-    std::vector<Node> q;
-    auto push = [&](int x, int y, int px, int py){
-      int id = idx(x,y);
-      if (visited[id]) return;
-      visited[id] = 1;
-      parent[id] = {x,y,px,py};
-      q.push_back({x,y,px,py});
-    };
-    push(sx, sy, -1, -1);
-    size_t qi = 0;
-    const int dx[4] = {0,1,0,-1};
-    const int dy[4] = {-1,0,1,0};
-    while (qi < q.size()) {
-      Node cur = q[qi++];
-      if (cur.x == tx && cur.y == ty) break;
-      for (int dir = 0; dir < 4; ++dir) {
-        // forbid immediate reverse from the start tile only
-        if (cur.x == sx && cur.y == sy && dir == ((forbidDir + 2) % 4)) continue;
-        int nx = cur.x + dx[dir];
-        int ny = cur.y + dy[dir];
-        if (nx < 0 || ny < 0 || nx >= BOARD_WIDTH || ny >= BOARD_HEIGHT) continue;
-        if (!passable(nx, ny)) continue;
-        push(nx, ny, cur.x, cur.y);
+      // Multi-source BFS over all cells so targets inside walls snap to the
+      // closest walkable tile.
+      beginVisit();
+      int qn = 0, qi = 0;
+      for (int w = 0; w < walkCount; ++w) {
+        visitStamp[walkCell[w]] = visitEpoch;
+        nearestWalkCell[walkCell[w]] = walkCell[w];
+        bfsQueue[qn++] = walkCell[w];
+      }
+      while (qi < qn) {
+        int c = bfsQueue[qi++];
+        int cx = c % BOARD_WIDTH, cy = c / BOARD_WIDTH;
+        for (int d = 0; d < 4; ++d) {
+          int nx = cx + DIR_DX[d], ny = cy + DIR_DY[d];
+          if (nx < 0 || ny < 0 || nx >= BOARD_WIDTH || ny >= BOARD_HEIGHT) continue;
+          int n = idx(nx, ny);
+          if (visitStamp[n] == visitEpoch) continue;
+          visitStamp[n] = visitEpoch;
+          nearestWalkCell[n] = nearestWalkCell[c];
+          bfsQueue[qn++] = n;
+        }
       }
     }
-    // Reconstruct path from target back to start
-    int tid = idx(tx, ty);
-    if (!visited[tid]) return randomDirExcept(forbidDir); // no path
-    int cx = tx, cy = ty;
-    int px = parent[tid].px, py = parent[tid].py;
-    while (!(px == -1 && py == -1)) {
-      if (px == sx && py == sy) {
-        // first step from start to (cx,cy)
-        if (cx == sx && cy == sy-1) return 0;
-        if (cx == sx+1 && cy == sy) return 1;
-        if (cx == sx && cy == sy+1) return 2;
-        if (cx == sx-1 && cy == sy) return 3;
+
+    void resetGame(uint64_t gameSeed) {
+      // Lite mode: fixed single map for predictable gameplay quality.
+      seedMap();
+      pacmanX = 13; pacmanY = 23; pacmanDir = 1;
+      pacmanPendingDir = -1;
+      input.clear();
+      if (!navReady) {
+        buildNavigation();
+        navReady = true;
       }
-      int id = idx(px, py);
-      int npx = parent[id].px;
-      int npy = parent[id].py;
-      cx = px; cy = py; px = npx; py = npy;
+      ghostSpeed = 2;
+      static const Ghost GHOST_TEMPLATES[4] = {
+        {13, 12, 0, BOARD_WIDTH - 2, 1, false, 60},
+        {14, 12, 1, 1, 1, false, 120},
+        {12, 12, 2, 1, BOARD_HEIGHT - 2, false, 180},
+        {15, 12, 3, BOARD_WIDTH - 2, BOARD_HEIGHT - 2, false, 240},
+      };
+      for (ghostCount = 0; ghostCount < requestedGhostCount; ++ghostCount) {
+        Ghost g = GHOST_TEMPLATES[ghostCount % 4];
+        if (ghostCount >= 4) {
+          // Extra swarm ghosts leave the open pen tiles in quick succession
+          g.x = 13 + (ghostCount & 1);
+          g.releaseTick = 240 + 20 * (ghostCount - 3);
+        }
+        ghosts[ghostCount] = g;
+      }
+      score = 0;
+      gameOver = false;
+      gameWon = false;
+      frightenedTimer = 0;
+      tickCount = 0;
+      rng.seed(gameSeed);
     }
-    return randomDirExcept(forbidDir);
-  }
 
-  int clamp(int v, int lo, int hi) { if (v < lo) return lo; if (v > hi) return hi; return v; }
+    void startGame(int level) {
+      uint64_t gameSeed = seeds.take();
+      resetGame(gameSeed);
+      // Reserves the whole log, so recording never allocates mid-game
+      replay.begin(REPLAY_TAG, gameSeed, requestedGhostCount, level);
+    }
 
-  void stepGhosts() {
-    ++tickCount;
-    if (tickCount % ghostSpeed != 0) return;
-    if (frightenedTimer > 0) frightenedTimer--;
+    // Back to tick 0 of the session's log: same ghosts, seed and inputs
+    void restartReplay() {
+      requestedGhostCount = replay.param(0);
+      resetGame(replay.seed());
+      replay.rewind();
+    }
 
-    for (auto &g : ghosts) {
-      if (!g.released) {
-        if ((int)tickCount >= g.releaseTick) g.released = true;
-        else continue;
-      }
+    bool canMove(int x, int y, int dir) {
+      int nx = x, ny = y;
+      if (dir == 0) ny -= 1; else if (dir == 1) nx += 1; else if (dir == 2) ny += 1; else if (dir == 3) nx -= 1;
+      return !isWall(nx, ny);
+    }
 
-      int reverseDir = (g.dir + 2) % 4;
-      int options[4];
-      int count = 0;
-      for (int d = 0; d < 4; ++d) {
-        if (d == reverseDir) continue;
-        if (canMove(g.x, g.y, d)) options[count++] = d;
-      }
+    bool moveIfFree(int &x, int &y, int dir) {
+      int nx = x, ny = y;
+      if (dir == 0) ny -= 1; else if (dir == 1) nx += 1; else if (dir == 2) ny += 1; else if (dir == 3) nx -= 1;
+      if (!isWall(nx, ny)) { x = nx; y = ny; return true; }
+      return false;
+    }
 
-      if (count == 0) {
-        if (canMove(g.x, g.y, reverseDir)) {
-          g.dir = reverseDir;
-          moveIfFree(g.x, g.y, g.dir);
-        }
-        continue;
+    void stepPacman() {
+      // Apply buffered turn if available and possible from current tile
+      if (pacmanPendingDir != -1 && canMove(pacmanX, pacmanY, pacmanPendingDir)) {
+        pacmanDir = pacmanPendingDir;
+        pacmanPendingDir = -1;
       }
-
-      bool atIntersection = count > 1;
-      bool shouldTurn = atIntersection && ((std::rand() % 100) < (frightenedTimer > 0 ? 85 : 55));
-      if (shouldTurn || !canMove(g.x, g.y, g.dir)) {
-        g.dir = options[std::rand() % count];
+      if (moveIfFree(pacmanX, pacmanY, pacmanDir)) {
+        char &cell = baseBoard[idx(pacmanX, pacmanY)];
+        if (cell == '.') { cell = ' '; score += 10; --pelletsRemaining; }
+        else if (cell == 'o') { cell = ' '; score += 50; frightenedTimer = FRIGHTENED_TICKS; --pelletsRemaining; }
       }
+    }
 
-      if (!moveIfFree(g.x, g.y, g.dir)) {
-        g.dir = options[std::rand() % count];
-        moveIfFree(g.x, g.y, g.dir);
+    bool inScatterMode() {
+      long long t = tickCount;
+      const int phases = (int)(sizeof(MODE_SCHEDULE) / sizeof(MODE_SCHEDULE[0]));
+      for (int i = 0; i < phases; ++i) {
+        if (t < MODE_SCHEDULE[i]) return (i % 2) == 0;
+        t -= MODE_SCHEDULE[i];
       }
+      return false;
     }
-  }
 
-  void checkCollision() {
-    for (auto &g : ghosts) {
-      if (g.x == pacmanX && g.y == pacmanY) {
-        if (frightenedTimer > 0) {
-          score += 200; // eat ghost, send back to pen
-          g.x = 13; g.y = 12; g.dir = 2;
-        } else {
-          gameOver = true; return;
+    // Classic per-ghost targeting; ghosts beyond the first four reuse the four
+    // personalities in turn (swarm mode).
+    void ghostTarget(int i, bool scatter, int &tx, int &ty) {
+      const Ghost &g = ghosts[i];
+      if (scatter) {
+        tx = g.scatterX;
+        ty = g.scatterY;
+      } else {
+        switch (i % 4) {
+          case 0: // chase Pacman directly
+            tx = pacmanX; ty = pacmanY;
+            break;
+          case 1: // ambush four tiles ahead of Pacman
+            tx = pacmanX + 4 * DIR_DX[pacmanDir]; ty = pacmanY + 4 * DIR_DY[pacmanDir];
+            break;
+          case 2: { // flank: mirror the lead ghost through the tile two ahead of Pacman
+            int ax = pacmanX + 2 * DIR_DX[pacmanDir], ay = pacmanY + 2 * DIR_DY[pacmanDir];
+            tx = 2 * ax - ghosts[0].x; ty = 2 * ay - ghosts[0].y;
+            break;
+          }
+          default: { // chase from afar, retreat to its corner when close
+            int dx = g.x - pacmanX, dy = g.y - pacmanY;
+            if (dx * dx + dy * dy > 64) { tx = pacmanX; ty = pacmanY; }
+            else { tx = g.scatterX; ty = g.scatterY; }
+            break;
+          }
         }
       }
+      tx = clamp(tx, 0, BOARD_WIDTH - 1);
+      ty = clamp(ty, 0, BOARD_HEIGHT - 1);
     }
-    // Win detection: no pellets or power pellets left
-    if (!gameOver) {
-      bool anyPellet = false;
-      for (int y = 0; y < BOARD_HEIGHT && !anyPellet; ++y) {
-        for (int x = 0; x < BOARD_WIDTH; ++x) {
-          char c = baseBoard[idx(x,y)];
-          if (c == '.' || c == 'o') { anyPellet = true; break; }
+
+    void stepGhosts() {
+      ++tickCount;
+      if (tickCount % ghostSpeed != 0) return;
+      if (frightenedTimer > 0) frightenedTimer--;
+      const bool scatter = inScatterMode();
+
+      for (int i = 0; i < ghostCount; ++i) {
+        Ghost &g = ghosts[i];
+        if (!g.released) {
+          if ((int)tickCount >= g.releaseTick) g.released = true;
+          else continue;
+        }
+
+        int reverseDir = (g.dir + 2) % 4;
+        int options[4];
+        int count = 0;
+        for (int d = 0; d < 4; ++d) {
+          if (d == reverseDir) continue;
+          if (canMove(g.x, g.y, d)) options[count++] = d;
+        }
+
+        if (count == 0) {
+          if (canMove(g.x, g.y, reverseDir)) {
+            g.dir = reverseDir;
+            moveIfFree(g.x, g.y, g.dir);
+          }
+          continue;
+        }
+
+        if (frightenedTimer == 0) {
+          // Table lookup toward the ghost's target; ghosts never reverse, so fall
+          // back to the first open way forward when the target lies behind.
+          int tx, ty;
+          ghostTarget(i, scatter, tx, ty);
+          int want = navDirToward(g.x, g.y, tx, ty);
+          if (want < 0 || want == reverseDir || !canMove(g.x, g.y, want)) {
+            want = canMove(g.x, g.y, g.dir) ? g.dir : options[0];
+          }
+          g.dir = want;
+          moveIfFree(g.x, g.y, g.dir);
+          continue;
+        }
+
+        // Frightened: wander, turning randomly at intersections
+        bool atIntersection = count > 1;
+        bool shouldTurn = atIntersection && (rng.below(100) < 85);
+        if (shouldTurn || !canMove(g.x, g.y, g.dir)) {
+          g.dir = options[rng.below(count)];
+        }
+
+        if (!moveIfFree(g.x, g.y, g.dir)) {
+          g.dir = options[rng.below(count)];
+          moveIfFree(g.x, g.y, g.dir);
         }
       }
-      if (!anyPellet) { gameWon = true; gameOver = true; }
     }
-  }
 
-  void resolveCollisionWithGhost(Ghost &g) {
-    if (frightenedTimer > 0) {
-      score += 200;
-      g.x = 13;
-      g.y = 12;
-      g.dir = 2;
-      g.released = false;
-      g.releaseTick = (int)tickCount + 60;
-    } else {
-      gameOver = true;
+    void resolveCollisionWithGhost(Ghost &g) {
+      if (frightenedTimer > 0) {
+        score += 200;
+        g.x = 13;
+        g.y = 12;
+        g.dir = 2;
+        g.released = false;
+        g.releaseTick = (int)tickCount + 60;
+      } else {
+        gameOver = true;
+      }
     }
-  }
 
-  // deterministic collision checks including tile-swap crossing
-  void checkCollisionDetailed(
-    int prevPacX,
-    int prevPacY,
-    const std::vector<int> &prevGhostX,
-    const std::vector<int> &prevGhostY
-  ) {
-    for (size_t i = 0; i < ghosts.size(); ++i) {
-      auto &g = ghosts[i];
-
-      // Same-tile overlap
-      if (g.x == pacmanX && g.y == pacmanY) {
-        resolveCollisionWithGhost(g);
-        if (gameOver) return;
-        continue;
+    // deterministic collision checks including tile-swap crossing
+    void checkCollisionDetailed(
+      int prevPacX,
+      int prevPacY,
+      const int *prevGhostX,
+      const int *prevGhostY
+    ) {
+      for (int i = 0; i < ghostCount; ++i) {
+        auto &g = ghosts[i];
+
+        // Same-tile overlap
+        if (g.x == pacmanX && g.y == pacmanY) {
+          resolveCollisionWithGhost(g);
+          if (gameOver) return;
+          continue;
+        }
+
+        // Crossing: Pacman and ghost swapped tiles in same tick
+        if (
+          prevPacX == g.x &&
+          prevPacY == g.y &&
+          prevGhostX[i] == pacmanX &&
+          prevGhostY[i] == pacmanY
+        ) {
+          resolveCollisionWithGhost(g);
+          if (gameOver) return;
+        }
       }
 
-      // Crossing: Pacman and ghost swapped tiles in same tick
-      if (
-        prevPacX == g.x &&
-        prevPacY == g.y &&
-        prevGhostX[i] == pacmanX &&
-        prevGhostY[i] == pacmanY
-      ) {
-        resolveCollisionWithGhost(g);
-        if (gameOver) return;
+      // Win detection: no pellets or power pellets left
+      if (pelletsRemaining == 0) {
+        gameWon = true;
+        gameOver = true;
       }
     }
 
-    // Win detection: no pellets or power pellets left
-    bool anyPellet = false;
-    for (int y = 0; y < BOARD_HEIGHT && !anyPellet; ++y) {
-      for (int x = 0; x < BOARD_WIDTH; ++x) {
-        char c = baseBoard[idx(x, y)];
-        if (c == '.' || c == 'o') {
-          anyPellet = true;
-          break;
-        }
+    void renderFrame() {
+      const int size = BOARD_WIDTH * BOARD_HEIGHT;
+      for (int i = 0; i < size; ++i) frameBuf[i] = (unsigned char)baseBoard[i];
+      // Ghosts first so Pacman wins on a shared tile (matches pacman_get_cell)
+      for (int i = 0; i < ghostCount; ++i) frameBuf[idx(ghosts[i].x, ghosts[i].y)] = 'G';
+      frameBuf[idx(pacmanX, pacmanY)] = 'P';
+      for (int i = 0; i < size; ++i) tileBuf[i] = TILE_OF[frameBuf[i]];
+      dirtyCount = -1;
+    }
+
+    unsigned char composeCell(int x, int y) {
+      if (x == pacmanX && y == pacmanY) return 'P';
+      for (int i = 0; i < ghostCount; ++i) {
+        if (ghosts[i].x == x && ghosts[i].y == y) return 'G';
       }
+      return (unsigned char)baseBoard[idx(x, y)];
     }
-    if (!anyPellet) {
-      gameWon = true;
-      gameOver = true;
+
+    void refreshCell(int x, int y) {
+      int id = idx(x, y);
+      unsigned char v = composeCell(x, y);
+      if (frameBuf[id] == v) return;
+      frameBuf[id] = v;
+      tileBuf[id] = TILE_OF[v];
+      if (dirtyCount < 0) return;
+      if (dirtyCount >= DIRTY_CAP) { dirtyCount = -1; return; }
+      dirtyCells[dirtyCount * 2] = id;
+      dirtyCells[dirtyCount * 2 + 1] = v;
+      dirtyCount++;
     }
-  }
-}
-extern "C" {
-  KEEPALIVE void pacman_start_game(int level) { resetGame(level); }
-  KEEPALIVE void pacman_set_direction(int dir) {
-    if (dir >= 0 && dir <= 3) {
-      // Buffer desired direction; applied at next step if possible
-      pacmanPendingDir = dir;
+
+    // Only tiles an entity left or entered can change within a tick (eaten pellets
+    // sit under Pacman), so recompose just those instead of the whole frame.
+    void updateFrame(
+      int prevPacX,
+      int prevPacY,
+      const int *prevGhostX,
+      const int *prevGhostY
+    ) {
+      refreshCell(prevPacX, prevPacY);
+      for (int i = 0; i < ghostCount; ++i) refreshCell(prevGhostX[i], prevGhostY[i]);
+      for (int i = 0; i < ghostCount; ++i) refreshCell(ghosts[i].x, ghosts[i].y);
+      refreshCell(pacmanX, pacmanY);
     }
-  }
-  KEEPALIVE int pacman_tick() {
-    if (gameOver) return 0;
-
-    const int prevPacX = pacmanX;
-    const int prevPacY = pacmanY;
-    std::vector<int> prevGhostX;
-    std::vector<int> prevGhostY;
-    prevGhostX.reserve(ghosts.size());
-    prevGhostY.reserve(ghosts.size());
-    for (const auto &g : ghosts) {
-      prevGhostX.push_back(g.x);
-      prevGhostY.push_back(g.y);
+
+    int writeSnapshot(void* out) const {
+      SnapshotWriter w(out);
+      PacmanSnapshot st = {pacmanX, pacmanY, pacmanDir, pacmanPendingDir,
+                           ghostCount, requestedGhostCount, ghostSpeed,
+                           score, pelletsRemaining, gameOver ? 1 : 0, gameWon ? 1 : 0, frightenedTimer};
+      w.put(SNAPSHOT_TAG);
+      w.put(st);
+      w.put((int64_t)tickCount);
+      w.put(rng);
+      w.put(seeds);
+      for (int i = 0; i < ghostCount; ++i) {
+        const Ghost &g = ghosts[i];
+        int32_t f[7] = {g.x, g.y, g.dir, g.scatterX, g.scatterY, g.released ? 1 : 0, g.releaseTick};
+        w.put(f);
+      }
+      w.packed2(BOARD_SIZE, [this](int i) {
+        char c = baseBoard[i];
+        return c == '#' ? 3 : c == 'o' ? 2 : c == '.' ? 1 : 0;
+      });
+      return w.written();
     }
 
-    stepPacman();
+    // render=false is replay fast-forward: inputs come from the loaded log
+    // only (the input ring and the log are left alone) and the frame is not
+    // updated; call renderFrame() afterwards.
+    int tick(bool render = true) {
+      if (gameOver) return 0;
+
+      // Inputs from a loaded replay that are due before this tick
+      replay.applyDue((int)tickCount, [this](int dir) { pacmanPendingDir = dir; });
+
+      // Live inputs since the last tick: only the latest direction counts
+      int wanted = -1;
+      if (render) {
+        input.drain([&wanted](const InputEvent &e) {
+          if (e.code == INPUT_DIRECTION && e.value >= 0 && e.value <= 3) wanted = e.value;
+          return true;
+        });
+      }
+      if (wanted >= 0) {
+        replay.record((int)tickCount, wanted);
+        pacmanPendingDir = wanted;
+      }
 
-    // Collision right after Pacman move (before ghosts move away)
-    checkCollisionDetailed(prevPacX, prevPacY, prevGhostX, prevGhostY);
-    if (gameOver) return 0;
+      const int prevPacX = pacmanX;
+      const int prevPacY = pacmanY;
+      int prevGhostX[MAX_GHOSTS];
+      int prevGhostY[MAX_GHOSTS];
+      for (int i = 0; i < ghostCount; ++i) {
+        prevGhostX[i] = ghosts[i].x;
+        prevGhostY[i] = ghosts[i].y;
+      }
+
+      stepPacman();
+
+      // Collision right after Pacman move (before ghosts move away)
+      checkCollisionDetailed(prevPacX, prevPacY, prevGhostX, prevGhostY);
+      if (gameOver) {
+        if (render) updateFrame(prevPacX, prevPacY, prevGhostX, prevGhostY);
+        return 0;
+      }
 
-    stepGhosts();
+      stepGhosts();
 
-    // Collision after ghosts moved, including crossing/swap cases
-    checkCollisionDetailed(prevPacX, prevPacY, prevGhostX, prevGhostY);
+      // Collision after ghosts moved, including crossing/swap cases
+      checkCollisionDetailed(prevPacX, prevPacY, prevGhostX, prevGhostY);
 
-    return gameOver ? 0 : 1;
+      if (render) updateFrame(prevPacX, prevPacY, prevGhostX, prevGhostY);
+      return gameOver ? 0 : 1;
+    }
+  };
+
+  SessionPool<Session> sessions;
+  Session* cur = sessions.defaultSession();
+
+  // Builds the shared navigation table from the fixed map without touching
+  // any live session, e.g. when a restore is the module's first call
+  void ensureNavigation() {
+    if (navReady) return;
+    Session scratch;
+    scratch.seedMap();
+    scratch.buildNavigation();
+    navReady = true;
+  }
+}
+#ifdef PACMAN_DEBUG_ALLOCS
+void* operator new(std::size_t size) {
+  ++heapAllocCount;
+  void* p = std::malloc(size ? size : 1);
+  if (!p) std::abort();
+  return p;
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#endif
+
+extern "C" {
+  // Session handles: pacman_create returns a new id (-1 when the pool is full),
+  // pacman_use selects the session every other pacman_* call acts on.
+  KEEPALIVE int pacman_create() { return sessions.create(); }
+  KEEPALIVE int pacman_destroy(int id) {
+    if (sessions.get(id) == cur) cur = sessions.defaultSession();
+    return sessions.destroy(id) ? 1 : 0;
+  }
+  KEEPALIVE int pacman_use(int id) {
+    Session* s = sessions.get(id);
+    if (!s) return 0;
+    cur = s;
+    return 1;
+  }
+  KEEPALIVE void pacman_start_game(int level) {
+    cur->startGame(level);
+    cur->renderFrame();
+    heapAllocCount = 0;
   }
+  // Seed for the following games; with the same inputs each game then plays
+  // out identically.
+  KEEPALIVE void pacman_set_seed(uint64_t seed) { cur->seeds.set(seed); }
+  // Number of ghosts for the next game (1..MAX_GHOSTS); >4 is swarm mode
+  KEEPALIVE int pacman_set_ghost_count(int count) {
+    if (count < 1 || count > MAX_GHOSTS) return 0;
+    cur->requestedGhostCount = count;
+    return 1;
+  }
+  // The session's input ring (see InputRing.h); JS writes INPUT_DIRECTION
+  // events into it directly and the next tick applies the latest one
+  KEEPALIVE InputRing* pacman_input_ptr() { return &cur->input; }
+  // Queues one direction input, for callers without access to the ring
+  KEEPALIVE void pacman_set_direction(int dir) { cur->input.push(INPUT_DIRECTION, dir); }
+  KEEPALIVE int pacman_tick() { return cur->tick(); }
   KEEPALIVE int pacman_update() { return pacman_tick(); }
-  KEEPALIVE int pacman_is_game_over() { return gameOver ? 1 : 0; }
-  KEEPALIVE int pacman_get_score() { return score; }
+  // The current game's input log, as bytes in WASM memory
+  KEEPALIVE const int32_t* pacman_replay_get_ptr() { return cur->replay.data(); }
+  KEEPALIVE int pacman_replay_get_size() { return cur->replay.bytes(); }
+  // Load a log from pacman_replay_get_ptr/size (copied) and restart its game
+  // at tick 0. Returns 1, or 0 if the log is invalid.
+  KEEPALIVE int pacman_replay_load(const void* ptr, int len) {
+    ReplayLog log;
+    if (!log.load(ptr, len, REPLAY_TAG)) return 0;
+    if (log.param(0) < 1 || log.param(0) > MAX_GHOSTS) return 0;
+    cur->replay = std::move(log); // keeps the reserved capacity
+    cur->restartReplay();
+    cur->renderFrame();
+    return 1;
+  }
+  // Re-simulate the log up to tick `tick` (rewinding first if it lies behind),
+  // composing the frame once at the end. Returns the tick reached, which is
+  // earlier if the game ended.
+  KEEPALIVE int pacman_replay_seek(int tick) {
+    Session &s = *cur;
+    if (s.replay.empty()) return -1;
+    // Inputs queued for the position being left behind would cut the log here
+    s.input.clear();
+    if (tick < s.tickCount) s.restartReplay();
+    while (s.tickCount < tick && s.tick(false)) {}
+    s.renderFrame();
+    return (int)s.tickCount;
+  }
+  // Binary save state of the current session (see PacmanSnapshot). JS allocates
+  // pacman_snapshot_size() bytes; pacman_snapshot writes them and returns the count.
+  KEEPALIVE int pacman_snapshot_size() { return cur->writeSnapshot(nullptr); }
+  KEEPALIVE int pacman_snapshot(void* ptr) { return ptr ? cur->writeSnapshot(ptr) : 0; }
+  // Replace the current session's game with a snapshot. Returns 1, or 0 (and
+  // leaves the session alone) if the blob is invalid. Clears the replay log.
+  KEEPALIVE int pacman_restore(const void* ptr, int len) {
+    SnapshotReader in(ptr, len);
+    uint32_t tag = 0;
+    PacmanSnapshot st;
+    int64_t ticks = 0;
+    Rng rng;
+    SeedChain seeds;
+    if (!in.get(tag) || tag != SNAPSHOT_TAG || !in.get(st) || !in.get(ticks) || !in.get(rng) || !in.get(seeds)) return 0;
+    if (st.ghostCount < 0 || st.ghostCount > MAX_GHOSTS) return 0;
+    if (st.requestedGhostCount < 1 || st.requestedGhostCount > MAX_GHOSTS || st.ghostSpeed < 1) return 0;
+    if (st.pacmanX < 0 || st.pacmanX >= BOARD_WIDTH || st.pacmanY < 0 || st.pacmanY >= BOARD_HEIGHT) return 0;
+    if (st.pacmanDir < 0 || st.pacmanDir > 3 || st.pacmanPendingDir < -1 || st.pacmanPendingDir > 3) return 0;
+    if (st.score < 0 || st.frightenedTimer < 0 || st.frightenedTimer > FRIGHTENED_TICKS) return 0;
+    const unsigned char* ghostData = in.view(st.ghostCount * 7 * 4);
+    const unsigned char* tiles = in.view(packedBytes2(BOARD_SIZE));
+    if (!in.done()) return 0;
+    // Navigation and walkId assume the fixed map's walls, so the blob must
+    // have exactly those (checked with the pellets below)
+    ensureNavigation();
+    Ghost ghosts[MAX_GHOSTS];
+    for (int i = 0; i < st.ghostCount; ++i) {
+      int32_t f[7];
+      std::memcpy(f, ghostData + i * sizeof f, sizeof f);
+      if (f[0] < 0 || f[0] >= BOARD_WIDTH || f[1] < 0 || f[1] >= BOARD_HEIGHT || f[2] < 0 || f[2] > 3) return 0;
+      if (f[3] < 0 || f[3] >= BOARD_WIDTH || f[4] < 0 || f[4] >= BOARD_HEIGHT) return 0;
+      ghosts[i] = {f[0], f[1], f[2], f[3], f[4], f[5] != 0, f[6]};
+    }
+    // Win detection counts pellets down, so the count must match the tiles
+    int pellets = 0;
+    for (int i = 0; i < BOARD_SIZE; ++i) {
+      char c = TILE_CODES[packed2At(tiles, i)];
+      if ((c == '#') != (walkId[i] < 0)) return 0;
+      if (c == '.' || c == 'o') ++pellets;
+    }
+    if (pellets != st.pelletsRemaining) return 0;
+
+    Session &s = *cur;
+    s.pacmanX = st.pacmanX;
+    s.pacmanY = st.pacmanY;
+    s.pacmanDir = st.pacmanDir;
+    s.pacmanPendingDir = st.pacmanPendingDir;
+    s.input.clear();
+    s.ghostCount = st.ghostCount;
+    for (int i = 0; i < st.ghostCount; ++i) s.ghosts[i] = ghosts[i];
+    s.requestedGhostCount = st.requestedGhostCount;
+    s.ghostSpeed = st.ghostSpeed;
+    s.score = st.score;
+    s.pelletsRemaining = pellets;
+    s.gameOver = st.gameOver != 0;
+    s.gameWon = st.gameWon != 0;
+    s.frightenedTimer = st.frightenedTimer;
+    s.tickCount = ticks;
+    s.rng = rng;
+    s.seeds = seeds;
+    for (int i = 0; i < BOARD_SIZE; ++i) s.baseBoard[i] = TILE_CODES[packed2At(tiles, i)];
+    s.replay.clear();
+    s.renderFrame();
+    return 1;
+  }
+  KEEPALIVE int pacman_is_game_over() { return cur->gameOver ? 1 : 0; }
+  KEEPALIVE int pacman_get_score() { return cur->score; }
+  KEEPALIVE int pacman_get_pellets_remaining() { return cur->pelletsRemaining; }
   KEEPALIVE int pacman_get_width() { return BOARD_WIDTH; }
   KEEPALIVE int pacman_get_height() { return BOARD_HEIGHT; }
+  // Whole board as one contiguous byte buffer, refreshed by start/tick.
+  // JS reads it zero-copy: HEAPU8.subarray(ptr, ptr + width * height).
+  KEEPALIVE unsigned char* pacman_get_frame_ptr() { return cur->frameBuf; }
+  KEEPALIVE unsigned char* pacman_render_frame() {
+    cur->renderFrame();
+    return cur->frameBuf;
+  }
+  // The frame as tile ids (see Tiles.h), refreshed along with the frame buffer
+  KEEPALIVE unsigned char* pacman_get_tiles_ptr() { return cur->tileBuf; }
+  KEEPALIVE int pacman_get_dirty_count() { return cur->dirtyCount; }
+  KEEPALIVE int* pacman_get_dirty_ptr() { return cur->dirtyCells; }
+  KEEPALIVE void pacman_clear_dirty() { cur->dirtyCount = 0; }
+  // -1 when the build does not track allocations
+  KEEPALIVE int pacman_debug_get_alloc_count() {
+#ifdef PACMAN_DEBUG_ALLOCS
+    return (int)heapAllocCount;
+#else
+    return -1;
+#endif
+  }
   KEEPALIVE int pacman_get_cell(int index) {
-    if (index < 0 || index >= (int)baseBoard.size()) return 0;
-    int x = index % BOARD_WIDTH;
-    int y = index / BOARD_WIDTH;
-    // Dynamic overlay: Pacman and ghosts override base tiles
-    if (x == pacmanX && y == pacmanY) return (int)('P');
-    for (int i = 0; i < (int)ghosts.size(); ++i) {
-      if (ghosts[i].x == x && ghosts[i].y == y) return (int)('G');
-    }
-    return (int)baseBoard[index];
+    if (index < 0 || index >= BOARD_SIZE) return 0;
+    return (int)cur->frameBuf[index];
   }
 }
 
-
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Input log for one game of a real-time engine: a small header (format tag,
+// game seed, two game parameters) followed by (tick, input) pairs in tick
+// order, all int32. Everything else about a game follows from its seed, so
+// re-simulating the log reproduces any state exactly.
+//
+// The cursor counts entries already applied. During normal play every input
+// is recorded as it happens, so the cursor stays at the end; after load() the
+// engine applies entries as its ticks come due, and a live input truncates
+// the log there and takes over. A cleared log (e.g. after restoring a
+// snapshot, which no log from tick 0 can describe) records nothing until the
+// next begin().
+//
+// A log holds at most MAX_INPUTS inputs. begin() and load() reserve room for
+// all of them, so record() never allocates on a tick; inputs past the limit
+// are dropped and overflowed() reports it.
+class ReplayLog {
+public:
+  static const int HEADER_WORDS = 6;
+  static const int MAX_INPUTS = 1 << 14;
+
+  void begin(int32_t tag, uint64_t seed, int32_t param0, int32_t param1) {
+    words.clear();
+    words.reserve(HEADER_WORDS + 2 * MAX_INPUTS);
+    overflow = false;
+    words.push_back(tag);
+    words.push_back((int32_t)(uint32_t)seed);
+    words.push_back((int32_t)(uint32_t)(seed >> 32));
+    words.push_back(param0);
+    words.push_back(param1);
+    words.push_back(0); // reserved
+    cursor = 0;
+  }
+
+  void record(int tick, int input) {
+    if (words.empty()) return;
+    const size_t keep = HEADER_WORDS + 2 * (size_t)cursor;
+    if (keep + 2 > words.capacity()) {
+      overflow = true;
+      return;
+    }
+    words.resize(keep);
+    words.push_back(tick);
+    words.push_back(input);
+    ++cursor;
+  }
+
+  // Takes a copy of a log produced by begin()/record(); false if it is not
+  // one of ours (wrong tag, truncated, or ticks out of order).
+  bool load(const void* data, int bytes, int32_t tag) {
+    if (!data || bytes < HEADER_WORDS * 4 || (bytes - HEADER_WORDS * 4) % 8 != 0) return false;
+    const int n = bytes / 4;
+    std::vector<int32_t> copy;
+    copy.reserve(n > HEADER_WORDS + 2 * MAX_INPUTS ? n : HEADER_WORDS + 2 * MAX_INPUTS);
+    copy.resize(n);
+    std::memcpy(copy.data(), data, bytes);
+    if (copy[0] != tag) return false;
+    for (int i = HEADER_WORDS + 2; i < n; i += 2) {
+      if (copy[i] < copy[i - 2]) return false;
+    }
+    words.swap(copy);
+    cursor = 0;
+    overflow = false;
+    return true;
+  }
+
+  // Calls apply(input) for every entry due at or before tick
+  template <typename Apply>
+  void applyDue(int tick, Apply apply) {
+    const int n = count();
+    while (cursor < n && words[HEADER_WORDS + 2 * cursor] <= tick) {
+      apply(words[HEADER_WORDS + 2 * cursor + 1]);
+      ++cursor;
+    }
+  }
+
+  void rewind() { cursor = 0; }
+
+  void clear() {
+    words.clear();
+    cursor = 0;
+    overflow = false;
+  }
+
+  bool empty() const { return words.empty(); }
+  bool overflowed() const { return overflow; }
+  uint64_t seed() const { return (uint64_t)(uint32_t)words[1] | ((uint64_t)(uint32_t)words[2] << 32); }
+  int32_t param(int i) const { return words[3 + i]; }
+  int count() const { return words.empty() ? 0 : ((int)words.size() - HEADER_WORDS) / 2; }
+
+  const int32_t* data() const { return words.data(); }
+  int bytes() const { return (int)words.size() * 4; }
+
+private:
+  std::vector<int32_t> words;
+  int cursor = 0;
+  bool overflow = false;
+};
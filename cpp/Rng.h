@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Small, fast PRNG shared by the engines: xoshiro128** (32-bit state words
+// and operations only, so it stays cheap on wasm32), seeded through
+// splitmix64 so every 64-bit seed, including 0, gives a well-mixed state.
+class Rng {
+public:
+  Rng() { seed(0); }
+
+  void seed(uint64_t s) {
+    for (int i = 0; i < 4; i += 2) {
+      uint64_t v = splitmix64(s);
+      state[i] = (uint32_t)v;
+      state[i + 1] = (uint32_t)(v >> 32);
+    }
+  }
+
+  uint32_t next() {
+    const uint32_t result = rotl(state[1] * 5, 7) * 9;
+    const uint32_t t = state[1] << 9;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 11);
+    return result;
+  }
+
+  // Uniform in [0, n) for n > 0, by multiply-shift instead of a modulo
+  int below(int n) { return (int)(((uint64_t)next() * (uint32_t)n) >> 32); }
+
+  // Uniform in [lo, hi]
+  int range(int lo, int hi) { return lo + below(hi - lo + 1); }
+
+  static uint64_t splitmix64(uint64_t &x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+
+  // Seed for sessions nobody seeded explicitly: the clock plus a counter, so
+  // back-to-back sessions differ. Read once per session, never per draw.
+  static uint64_t entropySeed() {
+    static uint64_t counter = 0;
+    uint64_t t = (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    return t ^ splitmix64(counter);
+  }
+
+private:
+  static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+  uint32_t state[4];
+};
+
+// Where each *_start_game gets its game seed. After *_set_seed(s) the games
+// that follow are reproducible in sequence; otherwise the chain starts from
+// entropySeed().
+struct SeedChain {
+  uint64_t nextSeed = Rng::entropySeed();
+
+  void set(uint64_t s) { nextSeed = s; }
+
+  uint64_t take() {
+    uint64_t s = nextSeed;
+    Rng::splitmix64(nextSeed);
+    return s;
+  }
+};
@@ -1,6 +1,10 @@
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#else
+#define EMSCRIPTEN_KEEPALIVE
+#endif
 #include <cstring>
-#include <chrono>
+#include "Rng.h"
 
 extern "C" {
   // Game choices: 0=Rock, 1=Paper, 2=Scissors
@@ -18,14 +22,9 @@ extern "C" {
   static bool game_ready = false;
   static bool show_result = false;
 
-  // Simple random number generator
-  static unsigned int rng_state = 1234567u;
-  static int rand_int(int maxExclusive) {
-    auto now = std::chrono::steady_clock::now();
-    auto time_seed = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-    rng_state = rng_state * 1103515245u + 12345u + (unsigned)time_seed;
-    return (int)((rng_state >> 16) % (unsigned)maxExclusive);
-  }
+  // Computer choices; reseeded from rps_seeds by rps_start_game()
+  static Rng rps_rng;
+  static SeedChain rps_seeds;
 
   // Determine winner: 0=tie, 1=player wins, 2=computer wins
   static int determine_winner(int player, int computer) {
@@ -41,8 +40,15 @@ extern "C" {
     return 2; // computer wins
   }
 
+  // Seed for the following rps_start_game(); the computer's choices then repeat
+  EMSCRIPTEN_KEEPALIVE
+  void rps_set_seed(uint64_t seed) {
+    rps_seeds.set(seed);
+  }
+
   EMSCRIPTEN_KEEPALIVE
   void rps_start_game() {
+    rps_rng.seed(rps_seeds.take());
     player_choice = -1;
     computer_choice = -1;
     last_result = -1;
@@ -63,7 +69,7 @@ extern "C" {
     if (!game_ready || choice < 0 || choice > 2) return 0;
     
     player_choice = choice;
-    computer_choice = rand_int(3); // Generate computer choice
+    computer_choice = rps_rng.below(3); // Generate computer choice
     
     // Determine winner
     last_result = determine_winner(player_choice, computer_choice);
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+// Pooled storage for per-game sessions, shared by the engines.
+//
+// Sessions are carved out of fixed-size slabs, so creating one never moves
+// existing sessions and destroyed sessions are recycled instead of freed.
+// A handle packs the slot index with a generation counter, so a stale handle
+// to a destroyed (and possibly reused) slot is rejected. Handle 0 is the
+// built-in default session; it always exists and cannot be destroyed, which
+// keeps the original single-game API working unchanged.
+template <typename T, int SLAB_SIZE = 16>
+class SessionPool {
+public:
+  static const int SLOT_BITS = 16;
+  static const int MAX_SLOTS = 1 << SLOT_BITS;
+
+  SessionPool() {
+    grow();
+    freeSlots.pop_back(); // slot 0 is the default session
+    live[0] = true;
+  }
+
+  T* defaultSession() { return slots[0]; }
+
+  // Returns a new handle, or -1 when MAX_SLOTS sessions are live.
+  int create() {
+    if (freeSlots.empty()) {
+      if ((int)slots.size() >= MAX_SLOTS) return -1;
+      grow();
+    }
+    int slot = freeSlots.back();
+    freeSlots.pop_back();
+    live[slot] = true;
+    return (generation[slot] << SLOT_BITS) | slot;
+  }
+
+  bool destroy(int handle) {
+    int slot = slotOf(handle);
+    if (slot <= 0) return false;
+    *slots[slot] = T();
+    live[slot] = false;
+    generation[slot] = (generation[slot] + 1) & 0x7FFF;
+    freeSlots.push_back(slot);
+    return true;
+  }
+
+  T* get(int handle) {
+    int slot = slotOf(handle);
+    return slot < 0 ? nullptr : slots[slot];
+  }
+
+private:
+  int slotOf(int handle) const {
+    if (handle < 0) return -1;
+    int slot = handle & (MAX_SLOTS - 1);
+    if (slot >= (int)slots.size() || !live[slot]) return -1;
+    if ((handle >> SLOT_BITS) != generation[slot]) return -1;
+    return slot;
+  }
+
+  void grow() {
+    slabs.emplace_back(new T[SLAB_SIZE]());
+    T* slab = slabs.back().get();
+    int base = (int)slots.size();
+    for (int i = 0; i < SLAB_SIZE; ++i) {
+      slots.push_back(&slab[i]);
+      live.push_back(false);
+      generation.push_back(0);
+    }
+    // Hand out lower slots first
+    for (int i = SLAB_SIZE - 1; i >= 0; --i) freeSlots.push_back(base + i);
+  }
+
+  std::vector<std::unique_ptr<T[]>> slabs;
+  std::vector<T*> slots;
+  std::vector<bool> live;
+  std::vector<int> generation;
+  std::vector<int> freeSlots;
+};
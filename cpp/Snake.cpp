@@ -1,267 +1,527 @@
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#else
+#define EMSCRIPTEN_KEEPALIVE
+#endif
 #include <cstring>
+#include <utility>
+#include <vector>
+#include "InputRing.h"
+#include "Replay.h"
+#include "Rng.h"
+#include "SessionPool.h"
+#include "Snapshot.h"
+#include "Tiles.h"
 
 extern "C" {
-  // Board dimensions
-  static const int W = 20;
-  static const int H = 20;
-  static const int MAX_CELLS = W * H;
+  // Board dimensions, configurable at runtime up to MAX_SIDE x MAX_SIDE
+  static const int MIN_SIDE = 5;
+  static const int MAX_SIDE = 256;
+
+  // Changed cells since the last snake_clear_dirty(), as (index, value) pairs.
+  // dirty_count == -1 means the list overflowed and the whole board must be re-read.
+  static const int DIRTY_CAP = 64;
+
+  // Params are W, H. Only turns that took effect are logged, at most one per move.
+  static const int32_t REPLAY_TAG = 0x324B4E53; // "SNK2"
+
+  // snake_snapshot layout: tag, SnakeSnapshot, Rng, SeedChain, then as uint16
+  // cell indices the free list (in order, since food draws index into it) and
+  // the body from tail to head. Every other cell holds food. Queued inputs
+  // are not part of the snapshot.
+  static const uint32_t SNAPSHOT_TAG = 0x32534E53; // "SNS2"
+  struct SnakeSnapshot {
+    int32_t w, h, dir;
+    int32_t game_over, score, moves, game_running, move_interval_ms;
+    int32_t free_count, snake_length;
+  };
+
+  // One game. Every engine function works on a session; the exported API acts
+  // on the session selected with snake_use() (the default session 0 initially).
+  struct SnakeSession {
+    int W = 20;
+    int H = 20;
+    int cell_count = 20 * 20;
+
+    // Board cells: ' ' empty, 'S' snake, 'F' food (row stride is W).
+    // Sized to cell_count by clear_board(), so nothing reallocates mid-game.
+    std::vector<unsigned char> board;
+    // The same cells as tile ids for the renderer (see Tiles.h), kept in step with board
+    std::vector<unsigned char> tiles;
+
+    // Indices of every ' ' cell, kept in sync by set_cell() with swap-remove.
+    // free_slot[idx] is idx's position in free_cells, or -1 when occupied.
+    std::vector<int> free_cells;
+    std::vector<int> free_slot;
+    int free_count = 0;
+
+    // Snake body stored as a ring of indices into board (row*W + col).
+    // snake_tail is the slot of the tail; the head sits snake_length - 1 slots later.
+    std::vector<int> snake_positions;
+    int snake_tail = 0;
+    int snake_length = 0;
+
+    // Direction: 0=Up,1=Right,2=Down,3=Left
+    int dir = 1;
+    // Direction inputs not applied yet; rapid presses wait here and take
+    // effect one per move
+    InputRing input;
+
+    // Game state
+    int game_over = 0;
+    int score = 0;
+    int moves = 0;
+    bool game_running = false;
+
+    int move_interval_ms = 150; // Game speed - now configurable
+
+    int dirty_cells[DIRTY_CAP * 2] = {};
+    int dirty_count = -1;
+
+    // Food placement; reseeded from seeds on every snake_start_game()
+    Rng rng;
+    SeedChain seeds;
+
+    // This game's seed and direction inputs, keyed by moves (see Replay.h)
+    ReplayLog replay;
+  };
+
+  static SessionPool<SnakeSession> sessions;
+  static SnakeSession* cur = sessions.defaultSession();
+
+  static void mark_all_dirty(SnakeSession &s) {
+    s.dirty_count = -1;
+  }
+
+  static void free_add(SnakeSession &s, int idx) {
+    s.free_slot[idx] = s.free_count;
+    s.free_cells[s.free_count++] = idx;
+  }
+
+  static void free_remove(SnakeSession &s, int idx) {
+    int slot = s.free_slot[idx];
+    int last = s.free_cells[--s.free_count];
+    s.free_cells[slot] = last;
+    s.free_slot[last] = slot;
+    s.free_slot[idx] = -1;
+  }
+
+  static inline unsigned char tile_of(unsigned char v) {
+    return v == 'S' ? TILE_SNAKE : v == 'F' ? TILE_FOOD : TILE_EMPTY;
+  }
 
-  // Board cells: ' ' empty, 'S' snake, 'F' food
-  static unsigned char board[MAX_CELLS];
+  static void set_cell(SnakeSession &s, int idx, unsigned char v) {
+    if (s.board[idx] == ' ' && v != ' ') free_remove(s, idx);
+    else if (s.board[idx] != ' ' && v == ' ') free_add(s, idx);
+    s.board[idx] = v;
+    s.tiles[idx] = tile_of(v);
+    if (s.dirty_count < 0) return;
+    if (s.dirty_count >= DIRTY_CAP) {
+      mark_all_dirty(s);
+      return;
+    }
+    s.dirty_cells[s.dirty_count * 2] = idx;
+    s.dirty_cells[s.dirty_count * 2 + 1] = v;
+    s.dirty_count++;
+  }
 
-  // Snake body stored as list of indices into board (row*W + col)
-  static int snake_positions[MAX_CELLS];
-  static int snake_length;
+  static void clear_board(SnakeSession &s) {
+    if ((int)s.board.size() != s.cell_count) {
+      s.board.assign(s.cell_count, ' ');
+      s.tiles.assign(s.cell_count, TILE_EMPTY);
+      s.free_cells.assign(s.cell_count, 0);
+      s.free_slot.assign(s.cell_count, -1);
+      s.snake_positions.assign(s.cell_count, 0);
+    }
+    memset(s.board.data(), ' ', s.cell_count);
+    memset(s.tiles.data(), TILE_EMPTY, s.cell_count);
+    s.free_count = 0;
+    for (int i = 0; i < s.cell_count; ++i) free_add(s, i);
+    mark_all_dirty(s);
+  }
 
-  // Direction: 0=Up,1=Right,2=Down,3=Left
-  static int dir;
-  // Small queue to buffer rapid direction inputs
-  static int dir_queue[8];
-  static int dq_len;
+  static inline int ring_slot(const SnakeSession &s, int offset) {
+    int slot = s.snake_tail + offset;
+    return slot >= s.cell_count ? slot - s.cell_count : slot;
+  }
 
-  // Game state
-  static int game_over;
-  static int score;
-  static int moves;
-  static bool game_running;
+  static inline int body_head(const SnakeSession &s) { return s.snake_positions[ring_slot(s, s.snake_length - 1)]; }
+  static inline int body_tail(const SnakeSession &s) { return s.snake_positions[s.snake_tail]; }
 
-  static int MOVE_INTERVAL_MS = 150; // Game speed - now configurable
+  static inline void body_push_head(SnakeSession &s, int pos) {
+    s.snake_positions[ring_slot(s, s.snake_length)] = pos;
+    s.snake_length++;
+  }
 
-  static void clear_board() {
-    memset(board, ' ', MAX_CELLS);
+  static inline void body_pop_tail(SnakeSession &s) {
+    s.snake_tail = ring_slot(s, 1);
+    s.snake_length--;
   }
 
-  static void place_snake_initial() {
+  static void place_snake_initial(SnakeSession &s) {
     // Start at center, length 3 horizontal to the right
-    int r = H / 2;
-    int c = W / 2;
-    snake_length = 3;
-    snake_positions[0] = r * W + (c - 1);
-    snake_positions[1] = r * W + c;
-    snake_positions[2] = r * W + (c + 1);
-    for (int i = 0; i < snake_length; ++i) {
-      board[snake_positions[i]] = 'S';
+    int r = s.H / 2;
+    int c = s.W / 2;
+    s.snake_tail = 0;
+    s.snake_length = 0;
+    body_push_head(s, r * s.W + (c - 1));
+    body_push_head(s, r * s.W + c);
+    body_push_head(s, r * s.W + (c + 1));
+    for (int i = 0; i < s.snake_length; ++i) {
+      set_cell(s, s.snake_positions[ring_slot(s, i)], 'S');
     }
-    dir = 1; // Right
-    dq_len = 0; // clear queued inputs
+    s.dir = 1; // Right
+    s.input.clear();
   }
 
-  static unsigned int rng_state = 1234567u;
-  static int rand_int(int maxExclusive) {
-    // simple LCG
-    rng_state = rng_state * 1103515245u + 12345u + (unsigned)moves;
-    return (int)((rng_state >> 16) % (unsigned)maxExclusive);
+  static void spawn_food(SnakeSession &s) {
+    // Place food on a random empty cell: one draw into the free set
+    if (s.free_count == 0) return; // board is full
+    set_cell(s, s.free_cells[s.rng.below(s.free_count)], 'F');
   }
 
-  static void spawn_food() {
-    // Place food on a random empty cell
-    for (int tries = 0; tries < 2000; ++tries) {
-      int idx = rand_int(MAX_CELLS);
-      if (board[idx] == ' ') {
-        board[idx] = 'F';
-        return;
-      }
+  static void end_game(SnakeSession &s) {
+    s.game_over = 1;
+    s.game_running = false;
+  }
+
+  // Turns the snake unless newDir is invalid, its current heading or a
+  // direct reversal. Returns whether it turned.
+  static bool turn(SnakeSession &s, int newDir) {
+    if (newDir < 0 || newDir > 3 || newDir == s.dir || newDir == (s.dir + 2) % 4) return false;
+    s.dir = newDir;
+    return true;
+  }
+
+  // Single move kernel shared by snake_update, snake_tick, snake_step_n and
+  // replay seeks. live=false (seeking) takes turns from the loaded log only,
+  // leaving the input ring and the log untouched. Returns 1 if the snake
+  // moved, 0 if the game is not running or just ended.
+  static int step(SnakeSession &s, bool live = true) {
+    if (!s.game_running || s.game_over) return 0;
+
+    // At most one turn per move: a loaded replay's turn if one is due,
+    // otherwise the first queued input that changes the heading. Inputs that
+    // would not (same heading, reversal) are dropped; later ones wait for the
+    // next move.
+    bool turned = false;
+    s.replay.applyDue(s.moves, [&](int dir) { turned = turned || turn(s, dir); });
+    if (!turned && live) {
+      s.input.drain([&s](const InputEvent &e) {
+        if (e.code != INPUT_DIRECTION || !turn(s, e.value)) return true;
+        s.replay.record(s.moves, e.value);
+        return false;
+      });
     }
-    // Fallback: scan
-    for (int i = 0; i < MAX_CELLS; ++i) {
-      if (board[i] == ' ') {
-        board[i] = 'F';
-        return;
-      }
+
+    s.moves++;
+
+    int head = body_head(s);
+    int hr = head / s.W;
+    int hc = head % s.W;
+    if (s.dir == 0) hr -= 1;      // up
+    else if (s.dir == 1) hc += 1; // right
+    else if (s.dir == 2) hr += 1; // down
+    else if (s.dir == 3) hc -= 1; // left
+
+    // Wall collision
+    if (hr < 0 || hr >= s.H || hc < 0 || hc >= s.W) {
+      end_game(s);
+      return 0;
+    }
+
+    int newHead = hr * s.W + hc;
+
+    // Self collision: moving into the current tail is allowed because the
+    // tail vacates this tick (a food cell is never 'S', so no growth case)
+    if (s.board[newHead] == 'S' && newHead != body_tail(s)) {
+      end_game(s);
+      return 0;
     }
+
+    int ateFood = (s.board[newHead] == 'F');
+
+    // Move: if not growing, clear tail
+    if (!ateFood) {
+      set_cell(s, body_tail(s), ' ');
+      body_pop_tail(s);
+    } else {
+      // grow: keep the tail
+      s.score += 1;
+    }
+    body_push_head(s, newHead);
+
+    set_cell(s, newHead, 'S');
+
+    if (ateFood) {
+      spawn_food(s);
+    }
+
+    return 1;
+  }
+
+  static void begin_game(SnakeSession &s, uint64_t seed) {
+    s.rng.seed(seed);
+    clear_board(s);
+    s.game_over = 0;
+    s.score = 0;
+    s.moves = 0;
+    s.game_running = true;
+    place_snake_initial(s);
+    spawn_food(s);
+  }
+
+  // Back to move 0 of the session's log: same board size, seed and inputs
+  static void restart_replay(SnakeSession &s) {
+    s.W = s.replay.param(0);
+    s.H = s.replay.param(1);
+    s.cell_count = s.W * s.H;
+    begin_game(s, s.replay.seed());
+    s.replay.rewind();
+  }
+
+  static int write_snapshot(SnakeSession &s, void* out) {
+    if (s.board.empty()) clear_board(s);
+    SnapshotWriter w(out);
+    SnakeSnapshot st = {s.W, s.H, s.dir,
+                        s.game_over, s.score, s.moves, s.game_running ? 1 : 0, s.move_interval_ms,
+                        s.free_count, s.snake_length};
+    w.put(SNAPSHOT_TAG);
+    w.put(st);
+    w.put(s.rng);
+    w.put(s.seeds);
+    for (int i = 0; i < s.free_count; ++i) w.put((uint16_t)s.free_cells[i]);
+    for (int i = 0; i < s.snake_length; ++i) w.put((uint16_t)s.snake_positions[ring_slot(s, i)]);
+    return w.written();
+  }
+
+  // Session handles: create returns a new id (-1 when the pool is exhausted),
+  // use selects the session every other snake_* call acts on.
+  EMSCRIPTEN_KEEPALIVE int snake_create() { return sessions.create(); }
+
+  EMSCRIPTEN_KEEPALIVE
+  int snake_destroy(int id) {
+    if (sessions.get(id) == cur) cur = sessions.defaultSession();
+    return sessions.destroy(id) ? 1 : 0;
+  }
+
+  EMSCRIPTEN_KEEPALIVE
+  int snake_use(int id) {
+    SnakeSession* s = sessions.get(id);
+    if (!s) return 0;
+    cur = s;
+    return 1;
   }
 
   EMSCRIPTEN_KEEPALIVE
   void snake_start_game() {
-    clear_board();
-    game_over = 0;
-    score = 0;
-    moves = 0;
-    game_running = true;
-    place_snake_initial();
-    spawn_food();
+    SnakeSession &s = *cur;
+    uint64_t seed = s.seeds.take();
+    begin_game(s, seed);
+    s.replay.begin(REPLAY_TAG, seed, s.W, s.H);
+  }
+
+  // Seed for the following games; each snake_start_game() then replays the
+  // same sequence of food positions for the same inputs.
+  EMSCRIPTEN_KEEPALIVE
+  void snake_set_seed(uint64_t seed) {
+    cur->seeds.set(seed);
   }
 
   // Set difficulty: 1=Easy, 2=Normal, 3=Hard
   EMSCRIPTEN_KEEPALIVE
   void snake_set_difficulty(int level) {
     if (level == 1) {
-      MOVE_INTERVAL_MS = 200; // Easy - slower
+      cur->move_interval_ms = 200; // Easy - slower
     } else if (level == 3) {
-      MOVE_INTERVAL_MS = 100; // Hard - faster
+      cur->move_interval_ms = 100; // Hard - faster
     } else {
-      MOVE_INTERVAL_MS = 150; // Normal
+      cur->move_interval_ms = 150; // Normal
     }
   }
 
+  // Resize the board (each side MIN_SIDE..MAX_SIDE). Clears the board; call
+  // snake_start_game() afterwards. Returns 1 on success, 0 if out of range.
+  EMSCRIPTEN_KEEPALIVE
+  int snake_configure(int w, int h) {
+    if (w < MIN_SIDE || w > MAX_SIDE || h < MIN_SIDE || h > MAX_SIDE) return 0;
+    SnakeSession &s = *cur;
+    s.W = w;
+    s.H = h;
+    s.cell_count = w * h;
+    s.game_running = false;
+    s.game_over = 0;
+    clear_board(s);
+    return 1;
+  }
+
   EMSCRIPTEN_KEEPALIVE
   void snake_reset() {
     snake_start_game();
   }
 
+  // The session's input ring (see InputRing.h); JS writes INPUT_DIRECTION
+  // events into it directly and they apply at the next move
+  EMSCRIPTEN_KEEPALIVE InputRing* snake_input_ptr() { return &cur->input; }
+
+  // Queues one direction input, for callers without access to the ring
   EMSCRIPTEN_KEEPALIVE
   void snake_set_direction(int newDir) {
-    if (newDir < 0 || newDir > 3 || game_over) return;
-    // Determine the direction to compare against (last enqueued or current)
-    int lastDir = (dq_len > 0) ? dir_queue[dq_len - 1] : dir;
-    // Prevent direct reversal relative to the last planned direction
-    bool reverse = (lastDir == 0 && newDir == 2) || (lastDir == 2 && newDir == 0) ||
-                   (lastDir == 1 && newDir == 3) || (lastDir == 3 && newDir == 1);
-    if (reverse) return;
-    // Enqueue if space available
-    if (dq_len < 8) {
-      dir_queue[dq_len++] = newDir;
-    } else {
-      // If full, overwrite last to ensure most recent intent wins
-      dir_queue[dq_len - 1] = newDir;
-    }
+    cur->input.push(INPUT_DIRECTION, newDir);
   }
 
   // Autonomous update function - handles its own timing
   EMSCRIPTEN_KEEPALIVE
   int snake_update() {
-    if (!game_running || game_over) return 0;
-
-    // Apply at most one queued direction per move
-    if (dq_len > 0) {
-      dir = dir_queue[0];
-      // shift left
-      for (int i = 1; i < dq_len; ++i) dir_queue[i - 1] = dir_queue[i];
-      dq_len--;
-    }
-
-    moves++;
-
-    int head = snake_positions[snake_length - 1];
-    int hr = head / W;
-    int hc = head % W;
-    if (dir == 0) hr -= 1;      // up
-    else if (dir == 1) hc += 1; // right
-    else if (dir == 2) hr += 1; // down
-    else if (dir == 3) hc -= 1; // left
-
-    // Wall collision
-    if (hr < 0 || hr >= H || hc < 0 || hc >= W) {
-      game_over = 1;
-      game_running = false;
-      return 0;
-    }
-
-    int newHead = hr * W + hc;
-
-    // Self collision
-    if (board[newHead] == 'S') {
-      // Check if this is the tail and we're not growing
-      int tail = snake_positions[0];
-      if (newHead != tail || board[newHead] == 'F') {
-        game_over = 1;
-        game_running = false;
-        return 0;
-      }
-    }
-
-    int ateFood = (board[newHead] == 'F');
+    return step(*cur);
+  }
 
-    // Move: if not growing, clear tail
-    if (!ateFood) {
-      int tail = snake_positions[0];
-      board[tail] = ' ';
-      // shift positions left
-      for (int i = 1; i < snake_length; ++i) {
-        snake_positions[i - 1] = snake_positions[i];
-      }
-      snake_positions[snake_length - 1] = newHead;
-    } else {
-      // grow: append new head without removing tail
-      snake_positions[snake_length] = newHead;
-      snake_length++;
-      score += 1;
-    }
+  // Manual tick function for debug purposes
+  EMSCRIPTEN_KEEPALIVE
+  int snake_tick() {
+    return step(*cur);
+  }
 
-    board[newHead] = 'S';
+  // Run up to n moves in one call (catch-up after a stalled tab, headless runs).
+  // Returns how many moves completed before the game ended.
+  EMSCRIPTEN_KEEPALIVE
+  int snake_step_n(int n) {
+    SnakeSession &s = *cur;
+    int done = 0;
+    while (done < n && step(s)) ++done;
+    return done;
+  }
 
-    if (ateFood) {
-      spawn_food();
-    }
+  // The current game's input log, as bytes in WASM memory
+  EMSCRIPTEN_KEEPALIVE const int32_t* snake_replay_get_ptr() { return cur->replay.data(); }
+  EMSCRIPTEN_KEEPALIVE int snake_replay_get_size() { return cur->replay.bytes(); }
 
+  // Load a log from snake_replay_get_ptr/size (copied) and restart its game at
+  // move 0. Updates and inputs then continue from it. Returns 1, or 0 if invalid.
+  EMSCRIPTEN_KEEPALIVE
+  int snake_replay_load(const void* ptr, int len) {
+    ReplayLog log;
+    if (!log.load(ptr, len, REPLAY_TAG)) return 0;
+    int w = log.param(0), h = log.param(1);
+    if (w < MIN_SIDE || w > MAX_SIDE || h < MIN_SIDE || h > MAX_SIDE) return 0;
+    SnakeSession &s = *cur;
+    s.replay = std::move(log); // keeps the reserved capacity
+    restart_replay(s);
     return 1;
   }
 
-  // Manual tick function for debug purposes
+  // Re-simulate the log up to move `tick` (rewinding first if it lies behind),
+  // without rendering. Returns the move reached, which is earlier if the game ended.
   EMSCRIPTEN_KEEPALIVE
-  int snake_tick() {
-    if (game_over) return 0;
-    // For manual tick (debug), apply queued direction if any
-    if (dq_len > 0) {
-      dir = dir_queue[0];
-      for (int i = 1; i < dq_len; ++i) dir_queue[i - 1] = dir_queue[i];
-      dq_len--;
-    }
-    moves++;
-
-    int head = snake_positions[snake_length - 1];
-    int hr = head / W;
-    int hc = head % W;
-    if (dir == 0) hr -= 1;      // up
-    else if (dir == 1) hc += 1; // right
-    else if (dir == 2) hr += 1; // down
-    else if (dir == 3) hc -= 1; // left
-
-    // Wall collision
-    if (hr < 0 || hr >= H || hc < 0 || hc >= W) {
-      game_over = 1;
-      return 0;
-    }
+  int snake_replay_seek(int tick) {
+    SnakeSession &s = *cur;
+    if (s.replay.empty()) return -1;
+    // Inputs queued for the position being left behind would cut the log here
+    s.input.clear();
+    if (tick < s.moves) restart_replay(s);
+    while (s.moves < tick && step(s, false)) {}
+    mark_all_dirty(s);
+    return s.moves;
+  }
 
-    int newHead = hr * W + hc;
+  // Binary save state of the current session (see SnakeSnapshot). JS allocates
+  // snake_snapshot_size() bytes; snake_snapshot writes them and returns the count.
+  EMSCRIPTEN_KEEPALIVE int snake_snapshot_size() { return write_snapshot(*cur, nullptr); }
+  EMSCRIPTEN_KEEPALIVE int snake_snapshot(void* ptr) { return ptr ? write_snapshot(*cur, ptr) : 0; }
 
-    // Self collision (allow tail overlap if not growing)
-    if (board[newHead] == 'S') {
-      // If newHead equals current tail and we are not eating, it's okay (tail moves)
-      int tail = snake_positions[0];
-      if (!(newHead == tail && board[newHead] == 'S' && board[newHead] != 'F')) {
-        game_over = 1;
-        return 0;
-      }
+  // Replace the current session's game with a snapshot. Returns 1, or 0 (and
+  // leaves the session alone) if the blob is not a valid snapshot. The replay
+  // log is cleared, since it could no longer reproduce the game from its seed.
+  EMSCRIPTEN_KEEPALIVE
+  int snake_restore(const void* ptr, int len) {
+    SnapshotReader in(ptr, len);
+    uint32_t tag = 0;
+    SnakeSnapshot st;
+    Rng rng;
+    SeedChain seeds;
+    if (!in.get(tag) || tag != SNAPSHOT_TAG || !in.get(st) || !in.get(rng) || !in.get(seeds)) return 0;
+    if (st.w < MIN_SIDE || st.w > MAX_SIDE || st.h < MIN_SIDE || st.h > MAX_SIDE) return 0;
+    const int cells = st.w * st.h;
+    if (st.free_count < 0 || st.snake_length < 1) return 0;
+    if (st.dir < 0 || st.dir > 3) return 0;
+    const int food = cells - st.free_count - st.snake_length;
+    if (food < 0 || food > 1) return 0;
+    const unsigned char* free_list = in.view(2 * st.free_count);
+    const unsigned char* body = in.view(2 * st.snake_length);
+    if (!in.done()) return 0;
+    // Every free and body cell in range and listed once across both lists
+    std::vector<unsigned char> seen(cells, 0);
+    for (int i = 0; i < st.free_count + st.snake_length; ++i) {
+      int idx = i < st.free_count ? u16At(free_list, i) : u16At(body, i - st.free_count);
+      if (idx >= cells || seen[idx]) return 0;
+      seen[idx] = 1;
     }
 
-    int ateFood = (board[newHead] == 'F');
-
-    // Move: if not growing, clear tail
-    if (!ateFood) {
-      int tail = snake_positions[0];
-      board[tail] = ' ';
-      // shift positions left
-      for (int i = 1; i < snake_length; ++i) {
-        snake_positions[i - 1] = snake_positions[i];
-      }
-      snake_positions[snake_length - 1] = newHead;
+    SnakeSession &s = *cur;
+    s.W = st.w;
+    s.H = st.h;
+    s.cell_count = cells;
+    if ((int)s.board.size() != cells) {
+      s.board.assign(cells, 'F');
+      s.tiles.assign(cells, TILE_FOOD);
+      s.free_cells.assign(cells, 0);
+      s.free_slot.assign(cells, -1);
+      s.snake_positions.assign(cells, 0);
     } else {
-      // grow: append new head without removing tail
-      snake_positions[snake_length] = newHead;
-      snake_length++;
-      score += 1;
+      memset(s.board.data(), 'F', cells);
+      memset(s.tiles.data(), TILE_FOOD, cells);
+      for (int i = 0; i < cells; ++i) s.free_slot[i] = -1;
     }
-
-    board[newHead] = 'S';
-
-    if (ateFood) {
-      spawn_food();
+    s.free_count = st.free_count;
+    for (int i = 0; i < st.free_count; ++i) {
+      int idx = u16At(free_list, i);
+      s.board[idx] = ' ';
+      s.tiles[idx] = TILE_EMPTY;
+      s.free_cells[i] = idx;
+      s.free_slot[idx] = i;
     }
-
+    s.snake_tail = 0;
+    s.snake_length = st.snake_length;
+    for (int i = 0; i < st.snake_length; ++i) {
+      int idx = u16At(body, i);
+      s.board[idx] = 'S';
+      s.tiles[idx] = TILE_SNAKE;
+      s.snake_positions[i] = idx;
+    }
+    s.dir = st.dir;
+    s.input.clear();
+    s.game_over = st.game_over;
+    s.score = st.score;
+    s.moves = st.moves;
+    s.game_running = st.game_running != 0;
+    s.move_interval_ms = st.move_interval_ms;
+    s.rng = rng;
+    s.seeds = seeds;
+    s.replay.clear();
+    mark_all_dirty(s);
     return 1;
   }
 
-  EMSCRIPTEN_KEEPALIVE int snake_is_game_over() { return game_over; }
-  EMSCRIPTEN_KEEPALIVE int snake_get_score() { return score; }
-  EMSCRIPTEN_KEEPALIVE int snake_get_width() { return W; }
-  EMSCRIPTEN_KEEPALIVE int snake_get_height() { return H; }
-  EMSCRIPTEN_KEEPALIVE int snake_get_move_interval_ms() { return MOVE_INTERVAL_MS; }
+  EMSCRIPTEN_KEEPALIVE int snake_is_game_over() { return cur->game_over; }
+  EMSCRIPTEN_KEEPALIVE int snake_get_score() { return cur->score; }
+  EMSCRIPTEN_KEEPALIVE int snake_get_width() { return cur->W; }
+  EMSCRIPTEN_KEEPALIVE int snake_get_height() { return cur->H; }
+  EMSCRIPTEN_KEEPALIVE int snake_get_move_interval_ms() { return cur->move_interval_ms; }
 
-  EMSCRIPTEN_KEEPALIVE unsigned char* snake_get_board() { return board; }
+  EMSCRIPTEN_KEEPALIVE unsigned char* snake_get_board() {
+    if (cur->board.empty()) clear_board(*cur);
+    return cur->board.data();
+  }
+  // The board as tile ids (see Tiles.h), width * height bytes
+  EMSCRIPTEN_KEEPALIVE unsigned char* snake_get_tiles_ptr() {
+    if (cur->board.empty()) clear_board(*cur);
+    return cur->tiles.data();
+  }
+  EMSCRIPTEN_KEEPALIVE int snake_get_dirty_count() { return cur->dirty_count; }
+  EMSCRIPTEN_KEEPALIVE int* snake_get_dirty_ptr() { return cur->dirty_cells; }
+  EMSCRIPTEN_KEEPALIVE void snake_clear_dirty() { cur->dirty_count = 0; }
   EMSCRIPTEN_KEEPALIVE int snake_get_cell(int idx) {
-    if (idx < 0 || idx >= MAX_CELLS) return -1;
-    return (int)board[idx];
+    if (idx < 0 || idx >= (int)cur->board.size()) return -1;
+    return (int)cur->board[idx];
   }
 }
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// Binary state blobs for the engines' *_snapshot / *_restore exports: a 4-byte
+// format tag, then fields copied back to back in a fixed order (no padding,
+// no text), with boards packed as bytes or 2-bit codes. Cheap enough to take
+// every tick.
+//
+// A writer over a null buffer only counts, so the same code that writes a
+// snapshot also answers *_snapshot_size().
+class SnapshotWriter {
+public:
+  explicit SnapshotWriter(void* out) : out((unsigned char*)out) {}
+
+  void bytes(const void* src, int n) {
+    if (out) std::memcpy(out + size, src, n);
+    size += n;
+  }
+
+  template <typename T>
+  void put(const T &v) { bytes(&v, sizeof(T)); }
+
+  // count cells of 2-bit codes (code(i) in 0..3), four per byte
+  template <typename Code>
+  void packed2(int count, Code code) {
+    for (int i = 0; i < count; i += 4) {
+      unsigned char b = 0;
+      for (int j = 0; j < 4 && i + j < count; ++j) b |= (unsigned char)(code(i + j) << (2 * j));
+      put(b);
+    }
+  }
+
+  int written() const { return size; }
+
+private:
+  unsigned char* out;
+  int size = 0;
+};
+
+// Reads a blob back. Reads past the end fail and leave ok() false, so the
+// engines parse and check everything before touching the session.
+class SnapshotReader {
+public:
+  SnapshotReader(const void* data, int len) : in((const unsigned char*)data), len(data && len > 0 ? len : 0) {}
+
+  bool bytes(void* dst, int n) {
+    const unsigned char* p = view(n);
+    if (p) std::memcpy(dst, p, n);
+    return p != nullptr;
+  }
+
+  template <typename T>
+  bool get(T &v) { return bytes(&v, sizeof(T)); }
+
+  // The next n bytes in place, or null if the blob is too short
+  const unsigned char* view(int n) {
+    if (!valid || n < 0 || len - pos < n) {
+      valid = false;
+      return nullptr;
+    }
+    const unsigned char* p = in + pos;
+    pos += n;
+    return p;
+  }
+
+  bool ok() const { return valid; }
+  // Everything read and nothing left over
+  bool done() const { return valid && pos == len; }
+
+private:
+  const unsigned char* in;
+  int len;
+  int pos = 0;
+  bool valid = true;
+};
+
+inline int packedBytes2(int count) { return (count + 3) / 4; }
+inline int packed2At(const unsigned char* p, int i) { return (p[i >> 2] >> (2 * (i & 3))) & 3; }
+
+inline int u16At(const unsigned char* p, int i) {
+  uint16_t v;
+  std::memcpy(&v, p + 2 * i, 2);
+  return v;
+}
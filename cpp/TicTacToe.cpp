@@ -1,95 +1,192 @@
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#else
+#define EMSCRIPTEN_KEEPALIVE
+#endif
 #include <cstring>
-#include <cstdlib>
-#include <ctime>
-
-static char board[9]; // 0-8, 'X', 'O', or ' '
-static char current_player;
-static int moves;
-static bool rng_seeded = false;
-
-static const int WIN_LINES[8][3] = {
-    {0,1,2},{3,4,5},{6,7,8},
-    {0,3,6},{1,4,7},{2,5,8},
-    {0,4,8},{2,4,6}
+#include <chrono>
+#include "Rng.h"
+#include "SessionPool.h"
+#include "Snapshot.h"
+
+// Generalized m,n,k-game: cols x rows board, win_len in a row. The classic
+// 3x3x3 game keeps its exact bitboard solver; other shapes use the threat
+// search further below.
+static const int MAX_SIDE = 19;
+static const int MAX_CELLS = MAX_SIDE * MAX_SIDE;
+static const int MIN_K = 3;
+static const int MAX_K = 6;
+static const int MAX_WINDOWS = 4 * MAX_CELLS;
+static const int MAX_CELL_WINDOWS = 4 * MAX_K;
+
+// One game: its shape, board and incremental search state. The exported API
+// and the engine below act on `ses`, the session selected with ttt_use().
+struct TttSession {
+    int cols = 3;
+    int rows = 3;
+    int win_len = 3;
+    int cell_count = 9;
+    bool classic = true;
+
+    char board[MAX_CELLS] = {}; // row-major, 'X', 'O', or ' ' (read by JS)
+    char current_player = 0;
+    int moves = 0;
+
+    // Bitboards: bit i is set when cell i holds that player's mark
+    unsigned int x_mask = 0;
+    unsigned int o_mask = 0;
+
+    // m,n,k window geometry and counts (see the threat engine below)
+    int window_total = 0;
+    unsigned char win_x[MAX_WINDOWS] = {};
+    unsigned char win_o[MAX_WINDOWS] = {};
+    short cell_windows[MAX_CELLS][MAX_CELL_WINDOWS] = {};
+    unsigned char cell_window_count[MAX_CELLS] = {};
+    int threat_value[MAX_K + 1] = {}; // value of a window holding c stones of one player
+    int eval_score = 0;               // O-positive sum of window values
+    int lines_x = 0;                  // completed windows per player
+    int lines_o = 0;
+    int stones = 0;
+    unsigned char near_count[MAX_CELLS] = {}; // stones within two cells (candidate filter)
+
+    int time_budget_ms = 10;
+
+    // Weaker difficulties' randomness; reseeded from seeds by ttt_start_game()
+    Rng rng;
+    SeedChain seeds;
 };
 
-static void seed_rng_once() {
-    if (!rng_seeded) {
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
-        rng_seeded = true;
-    }
-}
+// ttt_snapshot layout: tag, TttSnapshot, Rng, SeedChain, then the board as
+// 2-bit codes (0 empty, 1 X, 2 O). Window counts and masks are rebuilt.
+static const uint32_t SNAPSHOT_TAG = 0x53545454; // "TTTS"
+struct TttSnapshot {
+    int32_t cols, rows, win_len, time_budget_ms, moves, current_player;
+};
+
+// About 20 KB per session, so slabs stay small
+static SessionPool<TttSession, 4> sessions;
+static TttSession* ses = sessions.defaultSession();
+
+static const unsigned int FULL_MASK = 0x1FF;
+
+// Rows, columns and diagonals as cell masks
+static const unsigned int WIN_MASKS[8] = {
+    0x007, 0x038, 0x1C0,
+    0x049, 0x092, 0x124,
+    0x111, 0x054
+};
+
+static const int POW3[9] = {1, 3, 9, 27, 81, 243, 729, 2187, 6561};
 
-static int winner_for_board(const char* b) {
+// Transposition table keyed on (base-3 position, side to move). Values depend
+// only on the position, so entries stay valid across games.
+enum { TT_EMPTY = 0, TT_EXACT, TT_LOWER, TT_UPPER };
+static const int TT_SIZE = 19683 * 2;
+static signed char tt_value[TT_SIZE];
+static unsigned char tt_flag[TT_SIZE];
+
+static bool has_line(unsigned int m) {
     for (int i = 0; i < 8; ++i) {
-        int a = WIN_LINES[i][0], c1 = WIN_LINES[i][1], c2 = WIN_LINES[i][2];
-        if (b[a] != ' ' && b[a] == b[c1] && b[c1] == b[c2]) return b[a];
-    }
-    for (int i = 0; i < 9; ++i) {
-        if (b[i] == ' ') return 0;
+        if ((m & WIN_MASKS[i]) == WIN_MASKS[i]) return true;
     }
-    return 'D';
+    return false;
+}
+
+static int winner_for_masks(unsigned int x, unsigned int o) {
+    if (has_line(x)) return 'X';
+    if (has_line(o)) return 'O';
+    if ((x | o) == FULL_MASK) return 'D';
+    return 0;
+}
+
+static void mnk_place(int cell, char player);
+
+static void place_mark(int idx, char player) {
+    mnk_place(idx, player);
+    if (!ses->classic) return;
+    if (player == 'X') ses->x_mask |= 1u << idx;
+    else ses->o_mask |= 1u << idx;
 }
 
 static int random_available_move() {
-    int available[9];
+    int available[MAX_CELLS];
     int count = 0;
-    for (int i = 0; i < 9; ++i) {
-        if (board[i] == ' ') available[count++] = i;
+    for (int i = 0; i < ses->cell_count; ++i) {
+        if (ses->board[i] == ' ') available[count++] = i;
     }
     if (count == 0) return -1;
-    return available[std::rand() % count];
+    return available[ses->rng.below(count)];
 }
 
 static int find_winning_move(char player) {
+    unsigned int own = (player == 'X') ? ses->x_mask : ses->o_mask;
+    unsigned int empty = ~(ses->x_mask | ses->o_mask) & FULL_MASK;
     for (int i = 0; i < 9; ++i) {
-        if (board[i] != ' ') continue;
-        board[i] = player;
-        int win = winner_for_board(board);
-        board[i] = ' ';
-        if (win == player) return i;
+        unsigned int bit = 1u << i;
+        if ((empty & bit) && has_line(own | bit)) return i;
     }
     return -1;
 }
 
-static int minimax(bool maximizing) {
-    int result = winner_for_board(board);
+// Centre, corners, then edges: strong moves first tighten the window early
+static const int SEARCH_ORDER[9] = {4, 0, 2, 6, 8, 1, 3, 5, 7};
+
+// Alpha-beta minimax over the bitboards, O maximizing (+10 win, -10 loss, 0 draw)
+static int minimax(unsigned int x, unsigned int o, int key, bool maximizing, int alpha, int beta) {
+    int result = winner_for_masks(x, o);
     if (result == 'O') return 10;
     if (result == 'X') return -10;
     if (result == 'D') return 0;
 
-    if (maximizing) {
-        int best = -1000;
-        for (int i = 0; i < 9; ++i) {
-            if (board[i] != ' ') continue;
-            board[i] = 'O';
-            int score = minimax(false);
-            board[i] = ' ';
+    int slot = key * 2 + (maximizing ? 1 : 0);
+    if (tt_flag[slot] != TT_EMPTY) {
+        int v = tt_value[slot];
+        if (tt_flag[slot] == TT_EXACT) return v;
+        if (tt_flag[slot] == TT_LOWER && v >= beta) return v;
+        if (tt_flag[slot] == TT_UPPER && v <= alpha) return v;
+    }
+
+    const int alpha0 = alpha;
+    const int beta0 = beta;
+    unsigned int empty = ~(x | o) & FULL_MASK;
+    int best = maximizing ? -1000 : 1000;
+    for (int n = 0; n < 9; ++n) {
+        int i = SEARCH_ORDER[n];
+        unsigned int bit = 1u << i;
+        if (!(empty & bit)) continue;
+        if (maximizing) {
+            int score = minimax(x, o | bit, key + 2 * POW3[i], false, alpha, beta);
             if (score > best) best = score;
+            if (best > alpha) alpha = best;
+        } else {
+            int score = minimax(x | bit, o, key + POW3[i], true, alpha, beta);
+            if (score < best) best = score;
+            if (best < beta) beta = best;
         }
-        return best;
+        if (alpha >= beta) break;
     }
 
-    int best = 1000;
-    for (int i = 0; i < 9; ++i) {
-        if (board[i] != ' ') continue;
-        board[i] = 'X';
-        int score = minimax(true);
-        board[i] = ' ';
-        if (score < best) best = score;
-    }
+    tt_value[slot] = (signed char)best;
+    if (best <= alpha0) tt_flag[slot] = TT_UPPER;
+    else if (best >= beta0) tt_flag[slot] = TT_LOWER;
+    else tt_flag[slot] = TT_EXACT;
     return best;
 }
 
 static int best_minimax_move() {
+    int key = 0;
+    for (int i = 0; i < 9; ++i) {
+        if (ses->x_mask & (1u << i)) key += POW3[i];
+        else if (ses->o_mask & (1u << i)) key += 2 * POW3[i];
+    }
+    // Scan in index order and keep the first strictly better move (same choice
+    // as a full minimax); children only need to beat best_score to matter.
     int best_score = -1000;
     int best_move = -1;
     for (int i = 0; i < 9; ++i) {
-        if (board[i] != ' ') continue;
-        board[i] = 'O';
-        int score = minimax(false);
-        board[i] = ' ';
+        unsigned int bit = 1u << i;
+        if ((ses->x_mask | ses->o_mask) & bit) continue;
+        int score = minimax(ses->x_mask, ses->o_mask | bit, key + 2 * POW3[i], false, best_score, 1000);
         if (score > best_score) {
             best_score = score;
             best_move = i;
@@ -98,57 +195,406 @@ static int best_minimax_move() {
     return best_move;
 }
 
+
+// ---- m,n,k threat engine ----
+
+static const int WIN_SCORE = 1000000000;
+static const int SEARCH_INF = WIN_SCORE + 1000;
+static const int MAX_BRANCH = 12;
+
+// Every run of win_len cells (a "window") keeps per-player stone counts. The
+// evaluation is the sum of window values, updated incrementally as stones are
+// placed and removed, so a move only touches the <= 4*win_len windows through it.
+static void mnk_build_windows() {
+    static const int DX[4] = {1, 0, 1, 1};
+    static const int DY[4] = {0, 1, 1, -1};
+    ses->window_total = 0;
+    for (int i = 0; i < ses->cell_count; ++i) ses->cell_window_count[i] = 0;
+    for (int y = 0; y < ses->rows; ++y) {
+        for (int x = 0; x < ses->cols; ++x) {
+            for (int d = 0; d < 4; ++d) {
+                int ex = x + DX[d] * (ses->win_len - 1);
+                int ey = y + DY[d] * (ses->win_len - 1);
+                if (ex < 0 || ex >= ses->cols || ey < 0 || ey >= ses->rows) continue;
+                int w = ses->window_total++;
+                for (int t = 0; t < ses->win_len; ++t) {
+                    int c = (y + DY[d] * t) * ses->cols + (x + DX[d] * t);
+                    ses->cell_windows[c][ses->cell_window_count[c]++] = (short)w;
+                }
+            }
+        }
+    }
+    // Each extra stone in an open window is worth 8x the previous one
+    ses->threat_value[0] = 0;
+    ses->threat_value[1] = 1;
+    for (int c = 2; c <= ses->win_len; ++c) ses->threat_value[c] = ses->threat_value[c - 1] * 8;
+}
+
+static void mnk_reset_state() {
+    for (int w = 0; w < ses->window_total; ++w) { ses->win_x[w] = 0; ses->win_o[w] = 0; }
+    for (int i = 0; i < ses->cell_count; ++i) ses->near_count[i] = 0;
+    ses->eval_score = 0;
+    ses->lines_x = 0;
+    ses->lines_o = 0;
+    ses->stones = 0;
+}
+
+static inline int window_value(int w) {
+    if (ses->win_x[w] && ses->win_o[w]) return 0;
+    if (ses->win_o[w]) return ses->threat_value[ses->win_o[w]];
+    if (ses->win_x[w]) return -ses->threat_value[ses->win_x[w]];
+    return 0;
+}
+
+static void adjust_near(int cell, int delta) {
+    int cx = cell % ses->cols, cy = cell / ses->cols;
+    for (int y = cy - 2; y <= cy + 2; ++y) {
+        if (y < 0 || y >= ses->rows) continue;
+        for (int x = cx - 2; x <= cx + 2; ++x) {
+            if (x < 0 || x >= ses->cols) continue;
+            ses->near_count[y * ses->cols + x] = (unsigned char)(ses->near_count[y * ses->cols + x] + delta);
+        }
+    }
+}
+
+static void mnk_place(int cell, char player) {
+    ses->board[cell] = player;
+    for (int i = 0; i < ses->cell_window_count[cell]; ++i) {
+        int w = ses->cell_windows[cell][i];
+        ses->eval_score -= window_value(w);
+        if (player == 'X') { if (++ses->win_x[w] == ses->win_len) ++ses->lines_x; }
+        else { if (++ses->win_o[w] == ses->win_len) ++ses->lines_o; }
+        ses->eval_score += window_value(w);
+    }
+    adjust_near(cell, 1);
+    ++ses->stones;
+}
+
+static void mnk_unplace(int cell, char player) {
+    for (int i = 0; i < ses->cell_window_count[cell]; ++i) {
+        int w = ses->cell_windows[cell][i];
+        ses->eval_score -= window_value(w);
+        if (player == 'X') { if (ses->win_x[w]-- == ses->win_len) --ses->lines_x; }
+        else { if (ses->win_o[w]-- == ses->win_len) --ses->lines_o; }
+        ses->eval_score += window_value(w);
+    }
+    adjust_near(cell, -1);
+    --ses->stones;
+    ses->board[cell] = ' ';
+}
+
+static int mnk_winner() {
+    if (ses->lines_x > 0) return 'X';
+    if (ses->lines_o > 0) return 'O';
+    if (ses->stones == ses->cell_count) return 'D';
+    return 0;
+}
+
+// An empty cell that completes a window for player, or -1
+static int mnk_find_winning_cell(char player) {
+    for (int c = 0; c < ses->cell_count; ++c) {
+        if (ses->board[c] != ' ' || ses->near_count[c] == 0) continue;
+        for (int i = 0; i < ses->cell_window_count[c]; ++i) {
+            int w = ses->cell_windows[c][i];
+            int own = (player == 'X') ? ses->win_x[w] : ses->win_o[w];
+            int opp = (player == 'X') ? ses->win_o[w] : ses->win_x[w];
+            if (own == ses->win_len - 1 && opp == 0) return c;
+        }
+    }
+    return -1;
+}
+
+// Candidate moves near existing stones, best first by how much they extend
+// the mover's open windows plus how much they cut the opponent's.
+static int mnk_gen_moves(char player, int* out, int limit) {
+    if (ses->stones == 0) {
+        out[0] = (ses->rows / 2) * ses->cols + ses->cols / 2;
+        return 1;
+    }
+    int prio[MAX_BRANCH];
+    int n = 0;
+    for (int c = 0; c < ses->cell_count; ++c) {
+        if (ses->board[c] != ' ' || ses->near_count[c] == 0) continue;
+        int p = 0;
+        for (int i = 0; i < ses->cell_window_count[c]; ++i) {
+            int w = ses->cell_windows[c][i];
+            int own = (player == 'X') ? ses->win_x[w] : ses->win_o[w];
+            int opp = (player == 'X') ? ses->win_o[w] : ses->win_x[w];
+            if (opp == 0) p += ses->threat_value[own + 1];
+            if (own == 0) p += ses->threat_value[opp + 1];
+        }
+        // Insertion into the bounded best-first list
+        int pos = n < limit ? n++ : limit;
+        while (pos > 0 && prio[pos - 1] < p) {
+            if (pos < limit) { prio[pos] = prio[pos - 1]; out[pos] = out[pos - 1]; }
+            --pos;
+        }
+        if (pos < limit) { prio[pos] = p; out[pos] = c; }
+    }
+    return n;
+}
+
+static long long search_nodes;
+static bool search_aborted;
+static std::chrono::steady_clock::time_point search_deadline;
+
+static bool out_of_time() {
+    if (search_aborted) return true;
+    if ((++search_nodes & 255) == 0 && std::chrono::steady_clock::now() >= search_deadline) {
+        search_aborted = true;
+    }
+    return search_aborted;
+}
+
+static int negamax(char player, int depth, int alpha, int beta, int ply) {
+    if (out_of_time()) return 0;
+    char opp = (player == 'X') ? 'O' : 'X';
+    if ((opp == 'X' ? ses->lines_x : ses->lines_o) > 0) return -(WIN_SCORE - ply); // opponent just won
+    if (ses->stones == ses->cell_count) return 0;
+    if (depth == 0) return (player == 'O') ? ses->eval_score : -ses->eval_score;
+
+    int list[MAX_BRANCH];
+    int n = mnk_gen_moves(player, list, MAX_BRANCH);
+    int best = -SEARCH_INF;
+    for (int i = 0; i < n; ++i) {
+        mnk_place(list[i], player);
+        int score = -negamax(opp, depth - 1, -beta, -alpha, ply + 1);
+        mnk_unplace(list[i], player);
+        if (search_aborted) return 0;
+        if (score > best) best = score;
+        if (best > alpha) alpha = best;
+        if (alpha >= beta) break;
+    }
+    return best;
+}
+
+// Iterative deepening for O within budget_ms; the previous iteration's best
+// move is searched first, and an unfinished iteration is discarded.
+static int mnk_search_move(int budget_ms, int max_depth) {
+    search_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budget_ms);
+    search_aborted = false;
+    search_nodes = 0;
+
+    int list[MAX_BRANCH];
+    int n = mnk_gen_moves('O', list, MAX_BRANCH);
+    if (n == 0) return -1;
+    int best_move = list[0];
+    int empties = ses->cell_count - ses->stones;
+    for (int depth = 1; depth <= max_depth && depth <= empties; ++depth) {
+        int iter_best = -1;
+        int iter_score = -SEARCH_INF;
+        int alpha = -SEARCH_INF;
+        for (int i = 0; i < n; ++i) {
+            mnk_place(list[i], 'O');
+            int score = -negamax('X', depth - 1, -SEARCH_INF, -alpha, 1);
+            mnk_unplace(list[i], 'O');
+            if (search_aborted) break;
+            if (score > iter_score) { iter_score = score; iter_best = i; }
+            if (score > alpha) alpha = score;
+        }
+        if (search_aborted || iter_best < 0) break;
+        best_move = list[iter_best];
+        // Principal move first for the next, deeper iteration
+        for (int i = iter_best; i > 0; --i) list[i] = list[i - 1];
+        list[0] = best_move;
+        if (iter_score >= WIN_SCORE - 64 || iter_score <= -(WIN_SCORE - 64)) break; // result is forced
+    }
+    return best_move;
+}
+
+static int mnk_ai_move(int difficulty) {
+    int win_now = mnk_find_winning_cell('O');
+    int block_now = mnk_find_winning_cell('X');
+    if (difficulty <= 0) return random_available_move();
+    if (win_now >= 0) return win_now;
+    if (difficulty == 1) {
+        if (block_now >= 0 && ses->rng.below(100) < 60) return block_now;
+        int list[3];
+        int n = mnk_gen_moves('O', list, 3);
+        return n > 0 ? list[ses->rng.below(n)] : random_available_move();
+    }
+    if (block_now >= 0) return block_now;
+    if (difficulty == 2) return mnk_search_move(ses->time_budget_ms, 2);
+    return mnk_search_move(ses->time_budget_ms, ses->cell_count);
+}
+
+static bool valid_shape(int m, int n, int k) {
+    if (m < 3 || m > MAX_SIDE || n < 3 || n > MAX_SIDE) return false;
+    return k >= MIN_K && k <= MAX_K && (k <= m || k <= n);
+}
+
+// Empty board of the current shape; the game's seed is up to the caller
+static void clear_game() {
+    if (ses->window_total == 0) mnk_build_windows();
+    memset(ses->board, ' ', ses->cell_count);
+    mnk_reset_state();
+    ses->x_mask = 0;
+    ses->o_mask = 0;
+    ses->current_player = 'X';
+    ses->moves = 0;
+}
+
+static int write_snapshot(void* out) {
+    SnapshotWriter w(out);
+    TttSnapshot st = {ses->cols, ses->rows, ses->win_len, ses->time_budget_ms, ses->moves, ses->current_player};
+    w.put(SNAPSHOT_TAG);
+    w.put(st);
+    w.put(ses->rng);
+    w.put(ses->seeds);
+    w.packed2(ses->cell_count, [](int i) { return ses->board[i] == 'X' ? 1 : ses->board[i] == 'O' ? 2 : 0; });
+    return w.written();
+}
+
 extern "C" {
+    // Session handles: ttt_create returns a new id (-1 when the pool is full),
+    // ttt_use selects the session every other ttt_* call acts on.
+    EMSCRIPTEN_KEEPALIVE int ttt_create() { return sessions.create(); }
+
+    EMSCRIPTEN_KEEPALIVE
+    int ttt_destroy(int id) {
+        if (sessions.get(id) == ses) ses = sessions.defaultSession();
+        return sessions.destroy(id) ? 1 : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int ttt_use(int id) {
+        TttSession* s = sessions.get(id);
+        if (!s) return 0;
+        ses = s;
+        return 1;
+    }
+
     EMSCRIPTEN_KEEPALIVE
     void ttt_start_game() {
-        seed_rng_once();
-        memset(board, ' ', 9);
-        current_player = 'X';
-        moves = 0;
+        ses->rng.seed(ses->seeds.take());
+        clear_game();
+    }
+
+    // Seed for the following games; the AI's random choices then repeat
+    // for the same moves.
+    EMSCRIPTEN_KEEPALIVE
+    void ttt_set_seed(uint64_t seed) {
+        ses->seeds.set(seed);
+    }
+
+    // Board of m columns x n rows won by k in a row (3..19 per side, k 3..6
+    // and no longer than the board). 3,3,3 is the classic game. Starts a new
+    // game; returns 1 on success, 0 if the shape is invalid.
+    EMSCRIPTEN_KEEPALIVE
+    int ttt_configure(int m, int n, int k) {
+        if (!valid_shape(m, n, k)) return 0;
+        ses->cols = m;
+        ses->rows = n;
+        ses->win_len = k;
+        ses->cell_count = m * n;
+        ses->classic = (m == 3 && n == 3 && k == 3);
+        mnk_build_windows();
+        ttt_start_game();
+        return 1;
+    }
+
+    // Binary save state of the current session (see TttSnapshot). JS allocates
+    // ttt_snapshot_size() bytes; ttt_snapshot writes them and returns the count.
+    EMSCRIPTEN_KEEPALIVE int ttt_snapshot_size() { return write_snapshot(nullptr); }
+    EMSCRIPTEN_KEEPALIVE int ttt_snapshot(void* ptr) { return ptr ? write_snapshot(ptr) : 0; }
+
+    // Replace the current session's game (shape included) with a snapshot.
+    // Returns 1, or 0 (and leaves the session alone) if the blob is invalid.
+    EMSCRIPTEN_KEEPALIVE
+    int ttt_restore(const void* ptr, int len) {
+        SnapshotReader in(ptr, len);
+        uint32_t tag = 0;
+        TttSnapshot st;
+        Rng rng;
+        SeedChain seeds;
+        if (!in.get(tag) || tag != SNAPSHOT_TAG || !in.get(st) || !in.get(rng) || !in.get(seeds)) return 0;
+        if (!valid_shape(st.cols, st.rows, st.win_len)) return 0;
+        if (st.current_player != 'X' && st.current_player != 'O') return 0;
+        if (st.time_budget_ms < 1 || st.time_budget_ms > 5000) return 0;
+        const int cells = st.cols * st.rows;
+        const unsigned char* board = in.view(packedBytes2(cells));
+        if (!in.done()) return 0;
+        for (int i = 0; i < cells; ++i) if (packed2At(board, i) == 3) return 0;
+
+        ses->cols = st.cols;
+        ses->rows = st.rows;
+        ses->win_len = st.win_len;
+        ses->cell_count = cells;
+        ses->classic = (st.cols == 3 && st.rows == 3 && st.win_len == 3);
+        mnk_build_windows();
+        clear_game();
+        for (int i = 0; i < cells; ++i) {
+            int code = packed2At(board, i);
+            if (code) place_mark(i, code == 1 ? 'X' : 'O');
+        }
+        ses->moves = st.moves;
+        ses->current_player = (char)st.current_player;
+        ses->time_budget_ms = st.time_budget_ms;
+        ses->rng = rng;
+        ses->seeds = seeds;
+        return 1;
+    }
+
+    EMSCRIPTEN_KEEPALIVE int ttt_get_width() { return ses->cols; }
+    EMSCRIPTEN_KEEPALIVE int ttt_get_height() { return ses->rows; }
+    EMSCRIPTEN_KEEPALIVE int ttt_get_win_length() { return ses->win_len; }
+
+    // Per-move thinking time for the search AI on non-classic boards
+    EMSCRIPTEN_KEEPALIVE
+    void ttt_set_time_budget_ms(int ms) {
+        if (ms < 1) ms = 1;
+        if (ms > 5000) ms = 5000;
+        ses->time_budget_ms = ms;
     }
 
     EMSCRIPTEN_KEEPALIVE
     char ttt_get_current_player() {
-        return current_player;
+        return ses->current_player;
     }
 
     EMSCRIPTEN_KEEPALIVE
     int ttt_make_move(int idx) {
-        if (idx < 0 || idx > 8 || board[idx] != ' ') return 0; // Invalid
-        board[idx] = current_player;
-        moves++;
+        if (idx < 0 || idx >= ses->cell_count || ses->board[idx] != ' ') return 0; // Invalid
+        place_mark(idx, ses->current_player);
+        ses->moves++;
         return 1; // Success
     }
 
     EMSCRIPTEN_KEEPALIVE
     void ttt_next_player() {
-        current_player = (current_player == 'X') ? 'O' : 'X';
+        ses->current_player = (ses->current_player == 'X') ? 'O' : 'X';
     }
 
     EMSCRIPTEN_KEEPALIVE
     char* ttt_get_board() {
-        return board;
+        return ses->board;
     }
 
     // New: Get a single cell value as an int (char code), -1 if invalid index
     EMSCRIPTEN_KEEPALIVE
     int ttt_get_cell(int idx) {
-        if (idx < 0 || idx > 8) return -1;
-        return (int)board[idx];
+        if (idx < 0 || idx >= ses->cell_count) return -1;
+        return (int)ses->board[idx];
     }
 
     EMSCRIPTEN_KEEPALIVE
     int ttt_check_winner() {
-        return winner_for_board(board);
+        return ses->classic ? winner_for_masks(ses->x_mask, ses->o_mask) : mnk_winner();
     }
 
     // difficulty: 0 easy, 1 medium, 2 hard, 3 impossible
     EMSCRIPTEN_KEEPALIVE
     int ttt_ai_move(int difficulty) {
-        if (current_player != 'O') return -1;
-        if (winner_for_board(board) != 0) return -1;
+        if (ses->current_player != 'O') return -1;
+        if (ttt_check_winner() != 0) return -1;
 
-        seed_rng_once();
+        if (!ses->classic) {
+            int move = mnk_ai_move(difficulty);
+            if (move < 0 || move >= ses->cell_count || ses->board[move] != ' ') return -1;
+            place_mark(move, 'O');
+            ses->moves++;
+            return move;
+        }
 
         int move = -1;
         int win_now = find_winning_move('O');
@@ -158,29 +604,29 @@ extern "C" {
             move = random_available_move();
         } else if (difficulty == 1) {
             if (win_now >= 0) move = win_now;
-            else if (block_now >= 0 && (std::rand() % 100) < 60) move = block_now;
+            else if (block_now >= 0 && ses->rng.below(100) < 60) move = block_now;
             else move = random_available_move();
         } else if (difficulty == 2) {
             if (win_now >= 0) move = win_now;
             else if (block_now >= 0) move = block_now;
-            else if ((std::rand() % 100) < 75) move = best_minimax_move();
+            else if (ses->rng.below(100) < 75) move = best_minimax_move();
             else {
                 int preferred[5] = {4,0,2,6,8};
                 int candidates[5];
                 int count = 0;
                 for (int i = 0; i < 5; ++i) {
-                    if (board[preferred[i]] == ' ') candidates[count++] = preferred[i];
+                    if (ses->board[preferred[i]] == ' ') candidates[count++] = preferred[i];
                 }
-                if (count > 0) move = candidates[std::rand() % count];
+                if (count > 0) move = candidates[ses->rng.below(count)];
                 else move = random_available_move();
             }
         } else {
             move = best_minimax_move();
         }
 
-        if (move < 0 || move > 8 || board[move] != ' ') return -1;
-        board[move] = 'O';
-        moves++;
+        if (move < 0 || move > 8 || ses->board[move] != ' ') return -1;
+        place_mark(move, 'O');
+        ses->moves++;
         return move;
     }
 }
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+// Tile ids of the packed uint8 tile buffers the grid engines export
+// (*_get_tiles_ptr), one byte per cell in row-major order. The renderer
+// (src/render/tiles.ts) maps each id to a style, so the ids must match there.
+// Ids are shared across games; each game uses its own subset.
+static const uint8_t TILE_EMPTY = 0;
+static const uint8_t TILE_WALL = 1;
+static const uint8_t TILE_PELLET = 2;
+static const uint8_t TILE_POWER_PELLET = 3;
+static const uint8_t TILE_PACMAN = 4;
+static const uint8_t TILE_GHOST = 5;
+static const uint8_t TILE_SNAKE = 6;
+static const uint8_t TILE_FOOD = 7;
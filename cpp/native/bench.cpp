@@ -0,0 +1,390 @@
+// Micro-benchmarks for the engine hot paths, written as one JSON document to
+// stdout so results can be diffed between releases.
+//
+//   arcade_bench [--quick]
+//
+// Uses only the exported C API, so the same source builds natively (CMake
+// target arcade_bench) and with emcc for Node (scripts/bench-wasm.mjs).
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "Replay.h"
+#include "engines.h"
+
+namespace {
+  typedef std::chrono::steady_clock Clock;
+
+  double nsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  }
+
+  unsigned int benchState = 0x9E3779B9u;
+  int benchRand(int maxExclusive) {
+    benchState ^= benchState << 13;
+    benchState ^= benchState >> 17;
+    benchState ^= benchState << 5;
+    return (int)(benchState % (unsigned)maxExclusive);
+  }
+
+  // Keeps reads from being optimized away
+  volatile long long sink = 0;
+
+  struct Stats { double mean, p50, p99, max; };
+
+  Stats summarize(std::vector<double> &samples) {
+    Stats s = {0, 0, 0, 0};
+    if (samples.empty()) return s;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double v : samples) sum += v;
+    s.mean = sum / samples.size();
+    s.p50 = samples[samples.size() / 2];
+    s.p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    s.max = samples.back();
+    return s;
+  }
+
+  // Snake bot that follows a Hamiltonian cycle (H even): row 0 left to right,
+  // then zigzag through columns 1..W-1 down to the last row and back up
+  // column 0. It never collides, so the snake can grow until the board is full.
+  struct CycleBot {
+    int w, h, headX, headY;
+
+    void reset() { headX = w / 2 + 1; headY = h / 2; }
+
+    int nextDir() const {
+      if (headY == 0) return headX == w - 1 ? 2 : 1;
+      if (headX == 0) return 0;
+      bool rightward = (headY % 2) == 0;
+      if (rightward) return headX == w - 1 ? 2 : 1;
+      if (headX > 1) return 3;
+      return headY == h - 1 ? 3 : 2;
+    }
+
+    void advance(int dir) {
+      if (dir == 0) --headY; else if (dir == 1) ++headX; else if (dir == 2) ++headY; else --headX;
+    }
+  };
+
+  // Pacman bot for a single ghost: heads for the open neighbour farthest from
+  // the ghost by maze distance, which keeps it alive indefinitely.
+  int evasivePacmanDir() {
+    static const int DX[4] = {0, 1, 0, -1}, DY[4] = {-1, 0, 1, 0};
+    const int w = pacman_get_width(), h = pacman_get_height();
+    std::vector<int> dist(w * h, -1), queue;
+    int pac = -1;
+    for (int i = 0; i < w * h; ++i) {
+      int c = pacman_get_cell(i);
+      if (c == 'P') pac = i;
+      else if (c == 'G') { dist[i] = 0; queue.push_back(i); }
+    }
+    if (pac < 0) return -1;
+    for (size_t q = 0; q < queue.size(); ++q) {
+      int c = queue[q];
+      for (int d = 0; d < 4; ++d) {
+        int x = c % w + DX[d], y = c / w + DY[d];
+        if (x < 0 || y < 0 || x >= w || y >= h) continue;
+        int n = y * w + x;
+        if (dist[n] >= 0 || pacman_get_cell(n) == '#') continue;
+        dist[n] = dist[c] + 1;
+        queue.push_back(n);
+      }
+    }
+    int best = -1, bestDist = -1;
+    for (int d = 0; d < 4; ++d) {
+      int x = pac % w + DX[d], y = pac / w + DY[d];
+      if (x < 0 || y < 0 || x >= w || y >= h || pacman_get_cell(y * w + x) == '#') continue;
+      if (dist[y * w + x] > bestDist) { bestDist = dist[y * w + x]; best = d; }
+    }
+    return best;
+  }
+
+  // Flappy bot: flaps whenever the bird is within two cells of the bottom of
+  // the next gap. A flap rises further than that, so it never hits a pipe.
+  void steerFlappy() {
+    const int32_t* e = flappy_get_entities_ptr();
+    const int32_t fpOne = flappy_get_fp_one();
+    const int birdX = 6;
+    double bottom = flappy_get_height() / 2.0 + 3;
+    for (int i = 0; i < e[1]; ++i) {
+      const int32_t* pipe = e + 2 + i * 3;
+      if (pipe[0] / fpOne >= birdX) { bottom = pipe[1] + pipe[2]; break; }
+    }
+    if ((double)e[0] / fpOne >= bottom - 2) flappy_flap();
+  }
+
+  // Plays until n moves have been made, restarting finished games.
+  void benchSnakeUpdate(long long n) {
+    const int side = 20;
+    snake_configure(side, side);
+    CycleBot bot = {side, side, 0, 0};
+    snake_start_game();
+    bot.reset();
+    long long done = 0;
+    Clock::time_point start = Clock::now();
+    while (done < n) {
+      int dir = bot.nextDir();
+      snake_set_direction(dir);
+      if (snake_update()) {
+        bot.advance(dir);
+        ++done;
+      } else {
+        snake_start_game();
+        bot.reset();
+      }
+    }
+    double ns = nsSince(start);
+    std::printf("  \"snake_update\": {\"board\": \"%dx%d\", \"ticks\": %lld, \"ticks_per_sec\": %.0f},\n",
+                side, side, done, done * 1e9 / ns);
+  }
+
+  void benchPacmanTick(long long n) {
+    pacman_set_ghost_count(4);
+    pacman_start_game(1);
+    long long done = 0;
+    Clock::time_point start = Clock::now();
+    while (done < n) {
+      if ((done & 7) == 0) pacman_set_direction(benchRand(4));
+      ++done;
+      if (!pacman_tick()) pacman_start_game(1);
+    }
+    double ns = nsSince(start);
+    std::printf("  \"pacman_tick\": {\"ghosts\": 4, \"ticks\": %lld, \"ticks_per_sec\": %.0f},\n",
+                done, done * 1e9 / ns);
+  }
+
+  void benchFlappyTick(long long n) {
+    const int mid = flappy_get_height() / 2;
+    flappy_start_game();
+    flappy_flap();
+    long long done = 0;
+    Clock::time_point start = Clock::now();
+    while (done < n) {
+      if (flappy_get_bird_y() > mid) flappy_flap();
+      ++done;
+      if (!flappy_tick()) {
+        flappy_start_game();
+        flappy_flap();
+      }
+    }
+    double ns = nsSince(start);
+    std::printf("  \"flappy_tick\": {\"ticks\": %lld, \"ticks_per_sec\": %.0f},\n", done, done * 1e9 / ns);
+  }
+
+  // Latency of ttt_ai_move per difficulty, against a random opponent
+  void benchTicTacToe(int m, int n, int k, int movesPerDifficulty, bool last) {
+    ttt_configure(m, n, k);
+    const int cells = m * n;
+    for (int difficulty = 0; difficulty <= 3; ++difficulty) {
+      std::vector<double> samples;
+      while ((int)samples.size() < movesPerDifficulty) {
+        ttt_start_game();
+        while (!ttt_check_winner() && (int)samples.size() < movesPerDifficulty) {
+          while (!ttt_make_move(benchRand(cells))) {}
+          ttt_next_player();
+          if (ttt_check_winner()) break;
+          Clock::time_point start = Clock::now();
+          ttt_ai_move(difficulty);
+          samples.push_back(nsSince(start) / 1000.0);
+          ttt_next_player();
+        }
+      }
+      Stats s = summarize(samples);
+      std::printf("    {\"board\": \"%dx%dx%d\", \"difficulty\": %d, \"moves\": %d, "
+                  "\"mean_us\": %.2f, \"p50_us\": %.2f, \"p99_us\": %.2f, \"max_us\": %.2f}%s\n",
+                  m, n, k, difficulty, (int)samples.size(), s.mean, s.p50, s.p99, s.max,
+                  (last && difficulty == 3) ? "" : ",");
+    }
+  }
+
+  // Re-simulation speed of *_replay_seek over the game just recorded in the
+  // current session: rewinds and fast-forwards it to its end until at least
+  // minTicks ticks have been replayed.
+  template <typename Seek>
+  void benchReplaySeek(const char* name, Seek seek, long long minTicks, bool last) {
+    const int end = seek(1 << 30);
+    long long done = 0;
+    Clock::time_point start = Clock::now();
+    while (done < minTicks && end > 0) {
+      seek(0);
+      done += seek(end);
+    }
+    double ns = nsSince(start);
+    std::printf("    \"%s\": {\"game_ticks\": %d, \"ticks\": %lld, \"ticks_per_sec\": %.0f, "
+                "\"ms_per_100k_ticks\": %.3f}%s\n",
+                name, end, done, done * 1e9 / ns, ns / done * 100000 / 1e6, last ? "" : ",");
+  }
+
+  void benchReplays(long long minTicks) {
+    std::printf("  \"replay_seek\": {\n");
+    // One long Snake game: the cycle bot survives 100k moves on a 40x40 board
+    const int side = 40;
+    snake_configure(side, side);
+    snake_start_game();
+    CycleBot bot = {side, side, 0, 0};
+    bot.reset();
+    for (int moves = 0; moves < 100000; ++moves) {
+      int dir = bot.nextDir();
+      snake_set_direction(dir);
+      if (!snake_update()) break;
+      bot.advance(dir);
+    }
+    benchReplaySeek("snake", snake_replay_seek, minTicks, false);
+
+    // Pacman and Flappy: long games from bots that do not die, so the seek
+    // covers late-game state rather than repeating the opening. The Pacman
+    // bot turns often, so its game ends when the log is full.
+    const int fullLog = (ReplayLog::HEADER_WORDS + 2 * ReplayLog::MAX_INPUTS) * 4;
+    pacman_set_ghost_count(1);
+    pacman_start_game(1);
+    int lastDir = -1;
+    for (int t = 0; t < 100000 && pacman_replay_get_size() < fullLog; ++t) {
+      int dir = evasivePacmanDir();
+      if (dir >= 0 && dir != lastDir) pacman_set_direction(dir);
+      lastDir = dir;
+      if (!pacman_tick()) break;
+    }
+    benchReplaySeek("pacman", pacman_replay_seek, minTicks, false);
+
+    flappy_start_game();
+    flappy_flap();
+    for (int t = 0; t < 100000; ++t) {
+      steerFlappy();
+      if (!flappy_tick()) break;
+    }
+    benchReplaySeek("flappy", flappy_replay_seek, minTicks, true);
+    std::printf("  },\n");
+  }
+
+  // Cost of one *_snapshot and one *_restore of the current session's state
+  template <typename Size, typename Snap, typename Restore>
+  void benchSnapshot(const char* name, Size size, Snap snap, Restore restore, int reps, bool last) {
+    std::vector<unsigned char> blob(size());
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < reps; ++r) sink = sink + snap(blob.data());
+    double snapNs = nsSince(start) / reps;
+    start = Clock::now();
+    for (int r = 0; r < reps; ++r) sink = sink + restore(blob.data(), (int)blob.size());
+    double restoreNs = nsSince(start) / reps;
+    std::printf("    \"%s\": {\"bytes\": %d, \"snapshot_ns\": %.1f, \"restore_ns\": %.1f}%s\n",
+                name, (int)blob.size(), snapNs, restoreNs, last ? "" : ",");
+  }
+
+  void benchSnapshots(int reps) {
+    std::printf("  \"snapshot\": {\n");
+    snake_configure(20, 20);
+    snake_start_game();
+    snake_step_n(50);
+    benchSnapshot("snake", snake_snapshot_size, snake_snapshot, snake_restore, reps, false);
+    pacman_set_ghost_count(4);
+    pacman_start_game(1);
+    for (int t = 0; t < 50; ++t) pacman_tick();
+    benchSnapshot("pacman", pacman_snapshot_size, pacman_snapshot, pacman_restore, reps, false);
+    flappy_start_game();
+    benchSnapshot("flappy", flappy_snapshot_size, flappy_snapshot, flappy_restore, reps, false);
+    ttt_configure(15, 15, 5);
+    for (int i = 0; i < 6; ++i) ttt_make_move(i * 17);
+    benchSnapshot("ttt", ttt_snapshot_size, ttt_snapshot, ttt_restore, reps, true);
+    std::printf("  },\n");
+  }
+
+  template <typename GetCell>
+  void benchBoardRead(const char* name, int cells, int reps, GetCell getCell, bool last) {
+    long long acc = 0;
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < reps; ++r) {
+      for (int i = 0; i < cells; ++i) acc += getCell(i);
+    }
+    double ns = nsSince(start);
+    sink = sink + acc;
+    std::printf("    \"%s\": {\"cells\": %d, \"ns_per_board\": %.1f, \"ns_per_cell\": %.3f}%s\n",
+                name, cells, ns / reps, ns / reps / cells, last ? "" : ",");
+  }
+
+  void benchBoardReads(int reps) {
+    std::printf("  \"get_cell_full_board\": {\n");
+    snake_configure(20, 20);
+    snake_start_game();
+    benchBoardRead("snake", 20 * 20, reps, snake_get_cell, false);
+    pacman_start_game(1);
+    benchBoardRead("pacman", pacman_get_width() * pacman_get_height(), reps, pacman_get_cell, false);
+    flappy_start_game();
+    benchBoardRead("flappy", flappy_get_width() * flappy_get_height(), reps, flappy_get_cell, false);
+    ttt_configure(15, 15, 5);
+    benchBoardRead("ttt", 15 * 15, reps, ttt_get_cell, true);
+    std::printf("  },\n");
+  }
+
+  // Grows a snake along the Hamiltonian cycle and times the moves that eat
+  // (which spawn the next food) against plain moves, bucketed by fill level.
+  void benchFoodSpawn(int side) {
+    const int cells = side * side;
+    const int BUCKETS = 10;
+    double eatNs[BUCKETS] = {0}, plainNs[BUCKETS] = {0};
+    long long eats[BUCKETS] = {0}, plains[BUCKETS] = {0};
+
+    snake_configure(side, side);
+    snake_start_game();
+    CycleBot bot = {side, side, 0, 0};
+    bot.reset();
+    int length = 3;
+    while (!snake_is_game_over() && length < cells - 1) {
+      int dir = bot.nextDir();
+      snake_set_direction(dir);
+      int nx = bot.headX, ny = bot.headY;
+      if (dir == 0) --ny; else if (dir == 1) ++nx; else if (dir == 2) ++ny; else --nx;
+      bool eating = snake_get_cell(ny * side + nx) == 'F';
+      int bucket = length * BUCKETS / cells;
+      Clock::time_point start = Clock::now();
+      int moved = snake_update();
+      double ns = nsSince(start);
+      if (!moved) break;
+      bot.advance(dir);
+      if (eating) { eatNs[bucket] += ns; ++eats[bucket]; ++length; }
+      else { plainNs[bucket] += ns; ++plains[bucket]; }
+    }
+
+    std::printf("  \"snake_food_spawn\": {\"board\": \"%dx%d\", \"by_fill\": [\n", side, side);
+    for (int b = 0; b < BUCKETS; ++b) {
+      std::printf("    {\"fill_pct\": %d, \"eat_moves\": %lld, \"eat_move_ns\": %.1f, \"plain_move_ns\": %.1f}%s\n",
+                  b * 100 / BUCKETS, eats[b], eats[b] ? eatNs[b] / eats[b] : 0.0,
+                  plains[b] ? plainNs[b] / plains[b] : 0.0, b == BUCKETS - 1 ? "" : ",");
+    }
+    std::printf("  ]}\n");
+  }
+}
+
+int main(int argc, char** argv) {
+  bool quick = argc > 1 && !std::strcmp(argv[1], "--quick");
+  const long long ticks = quick ? 200000 : 2000000;
+
+  std::printf("{\n");
+#ifdef __EMSCRIPTEN__
+  std::printf("  \"target\": \"wasm\",\n");
+#else
+  std::printf("  \"target\": \"native\",\n");
+#endif
+  std::printf("  \"quick\": %s,\n", quick ? "true" : "false");
+  // Fixed seeds so every run times the same games
+  ttt_set_seed(1);
+  snake_set_seed(1);
+  pacman_set_seed(1);
+  flappy_set_seed(1);
+  benchSnakeUpdate(ticks);
+  benchPacmanTick(ticks);
+  benchFlappyTick(ticks);
+
+  std::printf("  \"ttt_ai_move\": [\n");
+  benchTicTacToe(3, 3, 3, quick ? 200 : 2000, false);
+  benchTicTacToe(15, 15, 5, quick ? 10 : 50, true);
+  std::printf("  ],\n");
+
+  benchReplays(ticks);
+  benchSnapshots(quick ? 2000 : 20000);
+  benchBoardReads(quick ? 2000 : 20000);
+  benchFoodSpawn(quick ? 32 : 64);
+  std::printf("}\n");
+  return 0;
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include "InputRing.h"
+#include "Tiles.h"
+
+// C API of the six game engines, as exported to JS. Native builds link the
+// same functions from the arcade_engines static library (see CMakeLists.txt).
+
+extern "C" {
+  // Guess The Number
+  void guess_set_seed(uint64_t seed);
+  void guess_start_game(int max_number);
+  void guess_set_hint_difficulty(int level);
+  int guess_make_guess(int guess);
+  int guess_make_guess_hint(int guess);
+  int guess_get_attempts();
+
+  // Rock Paper Scissors
+  void rps_set_seed(uint64_t seed);
+  void rps_start_game();
+  void rps_reset_stats();
+  int rps_make_choice(int choice);
+  void rps_new_round();
+  int rps_get_player_choice();
+  int rps_get_computer_choice();
+  int rps_get_result();
+  int rps_is_game_ready();
+  int rps_show_result();
+  int rps_get_player_wins();
+  int rps_get_computer_wins();
+  int rps_get_ties();
+  int rps_get_total_games();
+  int rps_get_win_rate();
+
+  // Tic Tac Toe (m,n,k)
+  int ttt_create();
+  int ttt_destroy(int id);
+  int ttt_use(int id);
+  void ttt_set_seed(uint64_t seed);
+  void ttt_start_game();
+  int ttt_configure(int m, int n, int k);
+  int ttt_get_width();
+  int ttt_get_height();
+  int ttt_get_win_length();
+  void ttt_set_time_budget_ms(int ms);
+  char ttt_get_current_player();
+  int ttt_make_move(int idx);
+  void ttt_next_player();
+  char* ttt_get_board();
+  int ttt_get_cell(int idx);
+  int ttt_check_winner();
+  int ttt_ai_move(int difficulty);
+  int ttt_snapshot_size();
+  int ttt_snapshot(void* ptr);
+  int ttt_restore(const void* ptr, int len);
+
+  // Snake
+  int snake_create();
+  int snake_destroy(int id);
+  int snake_use(int id);
+  void snake_set_seed(uint64_t seed);
+  void snake_start_game();
+  void snake_set_difficulty(int level);
+  int snake_configure(int w, int h);
+  void snake_reset();
+  void snake_set_direction(int dir);
+  InputRing* snake_input_ptr();
+  int snake_update();
+  int snake_tick();
+  int snake_step_n(int n);
+  int snake_is_game_over();
+  int snake_get_score();
+  int snake_get_width();
+  int snake_get_height();
+  int snake_get_move_interval_ms();
+  unsigned char* snake_get_board();
+  unsigned char* snake_get_tiles_ptr();
+  int snake_get_dirty_count();
+  int* snake_get_dirty_ptr();
+  void snake_clear_dirty();
+  int snake_get_cell(int idx);
+  int snake_snapshot_size();
+  int snake_snapshot(void* ptr);
+  int snake_restore(const void* ptr, int len);
+  const int32_t* snake_replay_get_ptr();
+  int snake_replay_get_size();
+  int snake_replay_load(const void* ptr, int len);
+  int snake_replay_seek(int tick);
+
+  // Pacman
+  int pacman_create();
+  int pacman_destroy(int id);
+  int pacman_use(int id);
+  void pacman_set_seed(uint64_t seed);
+  void pacman_start_game(int level);
+  int pacman_set_ghost_count(int count);
+  void pacman_set_direction(int dir);
+  InputRing* pacman_input_ptr();
+  int pacman_tick();
+  int pacman_update();
+  int pacman_is_game_over();
+  int pacman_get_score();
+  int pacman_get_pellets_remaining();
+  int pacman_get_width();
+  int pacman_get_height();
+  unsigned char* pacman_get_frame_ptr();
+  unsigned char* pacman_render_frame();
+  unsigned char* pacman_get_tiles_ptr();
+  int pacman_get_dirty_count();
+  int* pacman_get_dirty_ptr();
+  void pacman_clear_dirty();
+  int pacman_debug_get_alloc_count();
+  int pacman_get_cell(int index);
+  int pacman_snapshot_size();
+  int pacman_snapshot(void* ptr);
+  int pacman_restore(const void* ptr, int len);
+  const int32_t* pacman_replay_get_ptr();
+  int pacman_replay_get_size();
+  int pacman_replay_load(const void* ptr, int len);
+  int pacman_replay_seek(int tick);
+
+  // Flappy Bird
+  int flappy_create();
+  int flappy_destroy(int id);
+  int flappy_use(int id);
+  void flappy_set_seed(uint64_t seed);
+  void flappy_set_difficulty(int level);
+  int flappy_get_width();
+  int flappy_get_height();
+  int flappy_get_score();
+  int flappy_is_game_over();
+  int flappy_has_started();
+  double flappy_get_bird_y();
+  void flappy_start_game();
+  void flappy_flap();
+  InputRing* flappy_input_ptr();
+  int flappy_tick();
+  int flappy_update();
+  double flappy_advance(double elapsed_ms);
+  double flappy_get_render_bird_y(double alpha);
+  double flappy_get_render_scroll(double alpha);
+  int32_t* flappy_get_entities_ptr();
+  int flappy_get_fp_one();
+  int flappy_get_cell(int index);
+  int flappy_get_dirty_count();
+  int* flappy_get_dirty_ptr();
+  void flappy_clear_dirty();
+  int flappy_snapshot_size();
+  int flappy_snapshot(void* ptr);
+  int flappy_restore(const void* ptr, int len);
+  const int32_t* flappy_replay_get_ptr();
+  int flappy_replay_get_size();
+  int flappy_replay_load(const void* ptr, int len);
+  int flappy_replay_seek(int tick);
+}
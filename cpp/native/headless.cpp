@@ -0,0 +1,158 @@
+// Headless simulation driver for the native engine library.
+//
+//   arcade_headless <game> [games] [max_ticks] [seed]
+//
+// game is one of snake, pacman, flappy, ttt, rps, guess. Plays `games` rounds
+// with a simple random bot (up to max_ticks steps each) and prints a summary,
+// so the engines can be profiled, fuzzed or bulk-simulated without a browser.
+// Runs are reproducible: the seed drives both the bot and the engines.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "engines.h"
+
+namespace {
+  // xorshift32, so bot inputs are reproducible from the seed argument
+  unsigned int botState = 1;
+  int botRand(int maxExclusive) {
+    botState ^= botState << 13;
+    botState ^= botState >> 17;
+    botState ^= botState << 5;
+    return (int)(botState % (unsigned)maxExclusive);
+  }
+
+  struct Totals {
+    long long ticks = 0;
+    long long score = 0;
+    int wins = 0;
+  };
+
+  void runSnake(int games, int maxTicks, Totals &t) {
+    for (int g = 0; g < games; ++g) {
+      snake_start_game();
+      int ticks = 0;
+      while (ticks < maxTicks) {
+        if (botRand(4) == 0) snake_set_direction(botRand(4));
+        if (!snake_update()) break;
+        ++ticks;
+      }
+      t.ticks += ticks;
+      t.score += snake_get_score();
+    }
+  }
+
+  void runPacman(int games, int maxTicks, Totals &t) {
+    for (int g = 0; g < games; ++g) {
+      pacman_start_game(1);
+      int ticks = 0;
+      while (ticks < maxTicks) {
+        if (botRand(8) == 0) pacman_set_direction(botRand(4));
+        ++ticks;
+        if (!pacman_tick()) break;
+      }
+      t.ticks += ticks;
+      t.score += pacman_get_score();
+      if (pacman_get_pellets_remaining() == 0) ++t.wins;
+    }
+  }
+
+  void runFlappy(int games, int maxTicks, Totals &t) {
+    const int mid = flappy_get_height() / 2;
+    for (int g = 0; g < games; ++g) {
+      flappy_start_game();
+      flappy_flap();
+      int ticks = 0;
+      while (ticks < maxTicks) {
+        // Hover around the middle, with some noise
+        if (flappy_get_bird_y() > mid + botRand(5) - 2) flappy_flap();
+        ++ticks;
+        if (!flappy_tick()) break;
+      }
+      t.ticks += ticks;
+      t.score += flappy_get_score();
+    }
+  }
+
+  void runTicTacToe(int games, int difficulty, Totals &t) {
+    const int cells = ttt_get_width() * ttt_get_height();
+    for (int g = 0; g < games; ++g) {
+      ttt_start_game();
+      while (!ttt_check_winner()) {
+        while (!ttt_make_move(botRand(cells))) {}
+        ++t.ticks;
+        ttt_next_player();
+        if (ttt_check_winner()) break;
+        ttt_ai_move(difficulty);
+        ++t.ticks;
+        ttt_next_player();
+      }
+      if (ttt_check_winner() == 'O') ++t.wins;
+    }
+  }
+
+  void runRps(int games, Totals &t) {
+    rps_reset_stats();
+    rps_start_game();
+    for (int g = 0; g < games; ++g) {
+      rps_make_choice(botRand(3));
+      rps_new_round();
+    }
+    t.ticks = games;
+    t.wins = rps_get_player_wins();
+  }
+
+  void runGuess(int games, Totals &t) {
+    const int maxNumber = 100;
+    for (int g = 0; g < games; ++g) {
+      guess_start_game(maxNumber);
+      // Binary search on guess_make_guess's signed difference
+      int lo = 1, hi = maxNumber;
+      while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        int diff = guess_make_guess(mid);
+        if (diff == 0) { ++t.wins; break; }
+        if (diff < 0) lo = mid + 1; else hi = mid - 1;
+      }
+      t.ticks += guess_get_attempts();
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <snake|pacman|flappy|ttt|rps|guess> [games] [max_ticks] [seed]\n", argv[0]);
+    return 2;
+  }
+  const char* game = argv[1];
+  int games = argc > 2 ? std::atoi(argv[2]) : 100;
+  int maxTicks = argc > 3 ? std::atoi(argv[3]) : 10000;
+  unsigned long long seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1ull;
+  botState = (unsigned)seed ? (unsigned)seed : 1u;
+  // Same seed, same run: engines and bot are both seeded from it
+  guess_set_seed(seed);
+  rps_set_seed(seed);
+  ttt_set_seed(seed);
+  snake_set_seed(seed);
+  pacman_set_seed(seed);
+  flappy_set_seed(seed);
+
+  Totals t;
+  auto start = std::chrono::steady_clock::now();
+  if (!std::strcmp(game, "snake")) runSnake(games, maxTicks, t);
+  else if (!std::strcmp(game, "pacman")) runPacman(games, maxTicks, t);
+  else if (!std::strcmp(game, "flappy")) runFlappy(games, maxTicks, t);
+  else if (!std::strcmp(game, "ttt")) runTicTacToe(games, 3, t);
+  else if (!std::strcmp(game, "rps")) runRps(games, t);
+  else if (!std::strcmp(game, "guess")) runGuess(games, t);
+  else {
+    std::fprintf(stderr, "unknown game: %s\n", game);
+    return 2;
+  }
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  std::printf("game=%s games=%d steps=%lld wins=%d avg_score=%.2f elapsed_ms=%.2f steps_per_sec=%.0f\n",
+              game, games, t.ticks, t.wins, games > 0 ? (double)t.score / games : 0.0, ms,
+              ms > 0 ? t.ticks * 1000.0 / ms : 0.0);
+  return 0;
+}
@@ -0,0 +1,63 @@
+// Fresh-process snapshot restore check for the Pacman engine.
+//
+//   arcade_restore_check save <file>
+//   arcade_restore_check load <file>
+//
+// `save` plays a few hundred ticks, then writes the snapshot followed by the
+// score and pellets remaining at that point. `load` runs in a new process, so
+// pacman_restore is the module's very first call; it restores the blob and
+// exits non-zero unless the live counters match what was saved.
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "engines.h"
+
+namespace {
+  int save(const char* path) {
+    pacman_set_seed(7);
+    pacman_start_game(1);
+    const int dirs[4] = {0, 1, 2, 3};
+    for (int t = 0; t < 400 && !pacman_is_game_over(); ++t) {
+      if (t % 25 == 0) pacman_set_direction(dirs[(t / 25) % 4]);
+      pacman_tick();
+    }
+    std::vector<unsigned char> blob(pacman_snapshot_size());
+    pacman_snapshot(blob.data());
+    int expect[2] = {pacman_get_score(), pacman_get_pellets_remaining()};
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return 1;
+    int n = (int)blob.size();
+    std::fwrite(&n, sizeof n, 1, f);
+    std::fwrite(blob.data(), 1, blob.size(), f);
+    std::fwrite(expect, sizeof expect, 1, f);
+    std::fclose(f);
+    std::printf("saved score=%d pellets=%d\n", expect[0], expect[1]);
+    return 0;
+  }
+
+  int load(const char* path) {
+    FILE* f = std::fopen(path, "rb");
+    if (!f) return 1;
+    int n = 0, expect[2] = {0, 0};
+    if (std::fread(&n, sizeof n, 1, f) != 1 || n <= 0) { std::fclose(f); return 1; }
+    std::vector<unsigned char> blob(n);
+    bool ok = std::fread(blob.data(), 1, blob.size(), f) == blob.size() &&
+              std::fread(expect, sizeof expect, 1, f) == 1;
+    std::fclose(f);
+    if (!ok) return 1;
+    if (!pacman_restore(blob.data(), n)) {
+      std::printf("restore rejected the snapshot\n");
+      return 1;
+    }
+    int score = pacman_get_score(), pellets = pacman_get_pellets_remaining();
+    std::printf("restored score=%d pellets=%d (saved %d, %d)\n", score, pellets, expect[0], expect[1]);
+    return score == expect[0] && pellets == expect[1] ? 0 : 1;
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc == 3 && std::strcmp(argv[1], "save") == 0) return save(argv[2]);
+  if (argc == 3 && std::strcmp(argv[1], "load") == 0) return load(argv[2]);
+  std::fprintf(stderr, "usage: %s save|load <file>\n", argv[0]);
+  return 2;
+}
@@ -4,6 +4,8 @@ set -e
 CPP_DIR="cpp"
 BUILD_DIR="wasm_build"
 PUBLIC_DIR="public/wasm"
+# Exported functions per game, shared with scripts/build-wasm.mjs
+EXPORTS_FILE="scripts/wasm-exports.json"
 
 if [ "$1" == "clean" ]; then
     echo "Cleaning $BUILD_DIR and $PUBLIC_DIR..."
@@ -15,59 +17,49 @@ fi
 mkdir -p "$BUILD_DIR"
 mkdir -p "$PUBLIC_DIR"
 
+# Prints the export list for the named games as emcc's "['_a','_b',...]",
+# without duplicates (every game exports _malloc/_free)
+exports_for() {
+    node -e '
+      const all = JSON.parse(require("fs").readFileSync(process.argv[1], "utf8"));
+      const names = new Set(process.argv.slice(2).flatMap((g) => all[g] || []));
+      console.log("[" + [...names].map((n) => `'"'"'${n}'"'"'`).join(",") + "]");
+    ' "$EXPORTS_FILE" "$@"
+}
+
+# build <output name> <exports> <sources and emcc flags...>
+build() {
+    local name="$1" exports="$2"
+    shift 2
+    emcc "$@" --no-entry -s WASM=1 -s WASM_BIGINT=1 -s MODULARIZE=1 -s EXPORT_ES6=1 -s EXPORT_NAME="Module" \
+      -s EXPORTED_FUNCTIONS="$exports" \
+      -s EXPORTED_RUNTIME_METHODS="['cwrap','ccall','HEAPU8','HEAP32']" \
+      -o "$BUILD_DIR/$name.js"
+    # Copy to public directory under content-hashed names
+    node scripts/wasm-publish.mjs "$name"
+}
+
+# `make.sh core`: every engine linked into one ArcadeCore module, tuned for
+# size. Engine exports are already namespaced (snake_*, ttt_*, ...), so the
+# games share it without clashes.
+if [ "$1" == "core" ]; then
+    games=()
+    for src in "$CPP_DIR"/*.cpp; do games+=("$(basename "$src" .cpp)"); done
+    echo "Building ArcadeCore (${games[*]})..."
+    build ArcadeCore "$(exports_for "${games[@]}")" "$CPP_DIR"/*.cpp -Oz -flto
+    echo "Build complete. ArcadeCore is in $BUILD_DIR/ and published to $PUBLIC_DIR/"
+    exit 0
+fi
+
 for src in "$CPP_DIR"/*.cpp; do
     base=$(basename "$src" .cpp)
-    echo "Building $base..."
-    if [ "$base" == "GuessTheNumber" ]; then
-        emcc $src -O3 --no-entry -s WASM=1 -s MODULARIZE=1 -s EXPORT_NAME="Module" \
-          -s EXPORTED_FUNCTIONS="['_start_game','_set_hint_difficulty','_make_guess','_make_guess_hint','_get_attempts']" \
-          -s EXPORTED_RUNTIME_METHODS="['cwrap','ccall']" \
-          -o "$BUILD_DIR/$base.js"
-        # Copy to public directory
-        cp "$BUILD_DIR/$base.js" "$PUBLIC_DIR/"
-        cp "$BUILD_DIR/$base.wasm" "$PUBLIC_DIR/"
-    elif [ "$base" == "TicTacToe" ]; then
-        emcc $src -O3 --no-entry -s WASM=1 -s MODULARIZE=1 -s EXPORT_NAME="Module" \
-          -s EXPORTED_FUNCTIONS="['_malloc','_free','_ttt_start_game','_ttt_get_current_player','_ttt_make_move','_ttt_next_player','_ttt_get_board','_ttt_get_cell','_ttt_check_winner','_ttt_ai_move']" \
-          -s EXPORTED_RUNTIME_METHODS="['cwrap','ccall']" \
-          -o "$BUILD_DIR/$base.js"
-        # Copy to public directory
-        cp "$BUILD_DIR/$base.js" "$PUBLIC_DIR/"
-        cp "$BUILD_DIR/$base.wasm" "$PUBLIC_DIR/"
-    elif [ "$base" == "Snake" ]; then
-        emcc $src -O3 --no-entry -s WASM=1 -s MODULARIZE=1 -s EXPORT_NAME="Module" \
-          -s EXPORTED_FUNCTIONS="['_snake_start_game','_snake_reset','_snake_set_direction','_snake_set_difficulty','_snake_tick','_snake_update','_snake_is_game_over','_snake_get_score','_snake_get_width','_snake_get_height','_snake_get_move_interval_ms','_snake_get_board','_snake_get_cell']" \
-          -s EXPORTED_RUNTIME_METHODS="['cwrap','ccall']" \
-          -o "$BUILD_DIR/$base.js"
-        # Copy to public directory
-        cp "$BUILD_DIR/$base.js" "$PUBLIC_DIR/"
-        cp "$BUILD_DIR/$base.wasm" "$PUBLIC_DIR/"
-    elif [ "$base" == "RockPaperScissors" ]; then
-        emcc $src -O3 --no-entry -s WASM=1 -s MODULARIZE=1 -s EXPORT_NAME="Module" \
-          -s EXPORTED_FUNCTIONS="['_rps_start_game','_rps_is_game_ready','_rps_make_choice','_rps_get_player_choice','_rps_get_computer_choice','_rps_get_result','_rps_show_result','_rps_new_round','_rps_get_player_wins','_rps_get_computer_wins','_rps_get_ties','_rps_get_total_games','_rps_reset_stats','_rps_get_win_rate']" \
-          -s EXPORTED_RUNTIME_METHODS="['cwrap','ccall']" \
-          -o "$BUILD_DIR/$base.js"
-        # Copy to public directory
-        cp "$BUILD_DIR/$base.js" "$PUBLIC_DIR/"
-        cp "$BUILD_DIR/$base.wasm" "$PUBLIC_DIR/"
-    elif [ "$base" == "Pacman" ]; then
-        emcc $src -O3 --no-entry -s WASM=1 -s MODULARIZE=1 -s EXPORT_NAME="Module" \
-          -s EXPORTED_FUNCTIONS="['_pacman_start_game','_pacman_set_direction','_pacman_tick','_pacman_update','_pacman_is_game_over','_pacman_get_score','_pacman_get_width','_pacman_get_height','_pacman_get_cell']" \
-          -s EXPORTED_RUNTIME_METHODS="['cwrap','ccall']" \
-          -o "$BUILD_DIR/$base.js"
-        # Copy to public directory
-        cp "$BUILD_DIR/$base.js" "$PUBLIC_DIR/"
-        cp "$BUILD_DIR/$base.wasm" "$PUBLIC_DIR/"
-    elif [ "$base" == "FlappyBird" ]; then
-        emcc $src -O3 --no-entry -s WASM=1 -s MODULARIZE=1 -s EXPORT_NAME="Module" \
-          -s EXPORTED_FUNCTIONS="['_flappy_start_game','_flappy_flap','_flappy_set_difficulty','_flappy_tick','_flappy_update','_flappy_is_game_over','_flappy_has_started','_flappy_get_score','_flappy_get_width','_flappy_get_height','_flappy_get_cell','_flappy_get_bird_y']" \
-          -s EXPORTED_RUNTIME_METHODS="['cwrap','ccall']" \
-          -o "$BUILD_DIR/$base.js"
-        # Copy to public directory
-        cp "$BUILD_DIR/$base.js" "$PUBLIC_DIR/"
-        cp "$BUILD_DIR/$base.wasm" "$PUBLIC_DIR/"
+    exports=$(exports_for "$base")
+    if [ "$exports" == "[]" ]; then
+        echo "Skipping $base (not in $EXPORTS_FILE)"
+        continue
     fi
-    # each game will be an elif block
+    echo "Building $base..."
+    build "$base" "$exports" "$src" -O3
 done
 
-echo "Build complete. WASM modules are in $BUILD_DIR/ and copied to $PUBLIC_DIR/"
+echo "Build complete. WASM modules are in $BUILD_DIR/ and published to $PUBLIC_DIR/"
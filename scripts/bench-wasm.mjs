@@ -0,0 +1,81 @@
+import { mkdirSync, writeFileSync, existsSync, readdirSync } from "fs";
+import { resolve, join } from "path";
+import { spawn } from "child_process";
+
+// Builds cpp/native/bench.cpp together with the engines as a Node program and
+// runs it, so WASM numbers come from the same benchmark as the native target.
+//   node scripts/bench-wasm.mjs [--quick] [out.json]
+
+const CPP_DIR = resolve("cpp");
+const BUILD_DIR = resolve("wasm_build");
+
+function resolveEmcc() {
+  const isWin = process.platform === "win32";
+  const roots = [process.env.EMSDK, resolve("emsdk")].filter(Boolean);
+  for (const root of roots) {
+    const p = join(root, "upstream", "emscripten", isWin ? "emcc.bat" : "emcc");
+    if (existsSync(p)) return p;
+  }
+  return "emcc";
+}
+
+function run(cmd, args, options = {}) {
+  return new Promise((resolvePromise, reject) => {
+    const child = spawn(cmd, args, {
+      shell: process.platform === "win32",
+      ...options,
+    });
+    let stdout = "";
+    child.stdout?.on("data", (d) => (stdout += d));
+    child.on("close", (code) => {
+      if (code === 0) resolvePromise(stdout);
+      else reject(new Error(`${cmd} failed with code ${code}`));
+    });
+  });
+}
+
+async function main() {
+  const args = process.argv.slice(2);
+  const quick = args.includes("--quick");
+  const outFile = args.find((a) => !a.startsWith("--"));
+
+  mkdirSync(BUILD_DIR, { recursive: true });
+  const sources = readdirSync(CPP_DIR)
+    .filter((f) => f.endsWith(".cpp"))
+    .map((f) => resolve(CPP_DIR, f));
+  const out = resolve(BUILD_DIR, "arcade_bench.js");
+
+  console.error("Building arcade_bench for Node...");
+  await run(
+    resolveEmcc(),
+    [
+      ...sources,
+      resolve(CPP_DIR, "native", "bench.cpp"),
+      `-I${CPP_DIR}`,
+      `-I${resolve(CPP_DIR, "native")}`,
+      "-O3",
+      "-s",
+      "ENVIRONMENT=node",
+      "-s",
+      "ALLOW_MEMORY_GROWTH=1",
+      "-o",
+      out,
+    ],
+    { stdio: ["ignore", "inherit", "inherit"] }
+  );
+
+  const json = await run(process.execPath, [out, ...(quick ? ["--quick"] : [])], {
+    stdio: ["ignore", "pipe", "inherit"],
+  });
+  if (outFile) {
+    writeFileSync(outFile, json);
+    console.error(`Wrote ${outFile}`);
+  } else {
+    process.stdout.write(json);
+  }
+}
+
+main().catch((err) => {
+  console.error(err?.message || err);
+  process.exit(1);
+});
@@ -1,6 +1,7 @@
-import { mkdirSync, readdirSync, copyFileSync, existsSync } from "fs";
+import { mkdirSync, readdirSync, readFileSync, existsSync } from "fs";
 import { basename, resolve, join } from "path";
 import { spawn } from "child_process";
+import { publish } from "./wasm-publish.mjs";
 
 const CPP_DIR = resolve("cpp");
 const BUILD_DIR = resolve("wasm_build");
@@ -63,103 +64,77 @@ function runEmcc(args) {
   });
 }
 
-async function buildOne(src) {
-  const base = basename(src, ".cpp");
-  console.log(`Building ${base}...`);
-  const out = resolve(BUILD_DIR, `${base}.js`);
-  let exportedFunctions = [];
-
-  if (base === "GuessTheNumber") {
-    exportedFunctions = ["_start_game", "_make_guess", "_get_attempts"];
-  } else if (base === "TicTacToe") {
-    exportedFunctions = [
-      "_malloc",
-      "_free",
-      "_ttt_start_game",
-      "_ttt_get_current_player",
-      "_ttt_make_move",
-      "_ttt_next_player",
-      "_ttt_get_board",
-      "_ttt_get_cell",
-      "_ttt_check_winner",
-    ];
-  } else if (base === "Snake") {
-    exportedFunctions = [
-      "_snake_start_game",
-      "_snake_reset",
-      "_snake_set_direction",
-      "_snake_tick",
-      "_snake_is_game_over",
-      "_snake_get_score",
-      "_snake_get_width",
-      "_snake_get_height",
-      "_snake_get_board",
-      "_snake_get_cell",
-    ];
-  } else if (base === "Pacman") {
-    exportedFunctions = [
-      "_pacman_start_game",
-      "_pacman_set_direction",
-      "_pacman_tick",
-      "_pacman_update",
-      "_pacman_is_game_over",
-      "_pacman_get_score",
-      "_pacman_get_width",
-      "_pacman_get_height",
-      "_pacman_get_cell",
-    ];
-  } else if (base === "FlappyBird") {
-    exportedFunctions = [
-      "_flappy_start_game",
-      "_flappy_flap",
-      "_flappy_set_difficulty",
-      "_flappy_tick",
-      "_flappy_update",
-      "_flappy_is_game_over",
-      "_flappy_get_score",
-      "_flappy_get_width",
-      "_flappy_get_height",
-      "_flappy_get_cell",
-    ];
-  } else {
-    console.log(`Skipping unknown C++ source ${base}.cpp`);
-    return;
-  }
+// Exported functions per game, shared with make.sh
+const EXPORTS = JSON.parse(
+  readFileSync(resolve("scripts", "wasm-exports.json"), "utf8")
+);
 
+async function build(name, sources, exportedFunctions, optFlags) {
+  const out = resolve(BUILD_DIR, `${name}.js`);
   const args = [
-    src,
-    "-O3",
+    ...sources,
+    ...optFlags,
     "--no-entry",
     "-s",
     "WASM=1",
     "-s",
+    "WASM_BIGINT=1",
+    "-s",
     "MODULARIZE=1",
     "-s",
+    "EXPORT_ES6=1",
+    "-s",
     "EXPORT_NAME=Module",
     "-s",
     `EXPORTED_FUNCTIONS=[${exportedFunctions.map((s) => `'${s}'`).join(",")}]`,
     "-s",
-    "EXPORTED_RUNTIME_METHODS=['cwrap','ccall']",
+    "EXPORTED_RUNTIME_METHODS=['cwrap','ccall','HEAPU8','HEAP32']",
     "-o",
     out,
   ];
 
   await runEmcc(args);
 
-  copyFileSync(out, resolve(PUBLIC_DIR, `${base}.js`));
-  copyFileSync(
-    resolve(BUILD_DIR, `${base}.wasm`),
-    resolve(PUBLIC_DIR, `${base}.wasm`)
+  publish([name]);
+}
+
+async function buildOne(src) {
+  const base = basename(src, ".cpp");
+  if (!EXPORTS[base]) {
+    console.log(`Skipping unknown C++ source ${base}.cpp`);
+    return;
+  }
+  console.log(`Building ${base}...`);
+  await build(base, [src], EXPORTS[base], ["-O3"]);
+}
+
+// Every engine linked into one ArcadeCore module, tuned for size. Engine
+// exports are namespaced (snake_*, ttt_*, ...), so the games share it.
+async function buildCore(sources) {
+  const games = sources.map((src) => basename(src, ".cpp")).filter((g) => EXPORTS[g]);
+  console.log(`Building ArcadeCore (${games.join(" ")})...`);
+  const exportedFunctions = [...new Set(games.flatMap((g) => EXPORTS[g]))];
+  await build(
+    "ArcadeCore",
+    games.map((g) => resolve(CPP_DIR, `${g}.cpp`)),
+    exportedFunctions,
+    ["-Oz", "-flto"]
   );
 }
 
 async function main() {
   ensureDirs();
-  // Optional: allow specifying a single game name to build: `node scripts/build-wasm.mjs FlappyBird`
+  // Optional: allow specifying a single game name to build: `node scripts/build-wasm.mjs FlappyBird`,
+  // or `core` for the combined ArcadeCore module
   const only = process.argv[2];
   let sources = readdirSync(CPP_DIR)
     .filter((f) => f.endsWith(".cpp"))
     .map((f) => resolve(CPP_DIR, f));
+  if (only === "core") {
+    await buildCore(sources);
+    console.log(`Build complete. ArcadeCore is in ${BUILD_DIR}/ and published to ${PUBLIC_DIR}/`);
+    return;
+  }
   if (only) {
     const candidate = resolve(CPP_DIR, `${only}.cpp`);
     if (existsSync(candidate)) {
@@ -173,7 +148,7 @@ async function main() {
     await buildOne(src);
   }
   console.log(
-    `Build complete. WASM modules are in ${BUILD_DIR}/ and copied to ${PUBLIC_DIR}/`
+    `Build complete. WASM modules are in ${BUILD_DIR}/ and published to ${PUBLIC_DIR}/`
   );
 }
 
@@ -0,0 +1,44 @@
+import { existsSync, mkdirSync, readdirSync, readFileSync, rmSync, writeFileSync } from "fs";
+import { createHash } from "crypto";
+import { resolve } from "path";
+import { fileURLToPath } from "url";
+
+// Copies built modules from wasm_build/ to public/wasm/ under content-hashed
+// names (Snake.3f2a1b9c.js, Snake.8d0e4c17.wasm) and records them in
+// public/wasm/manifest.json, which the loader reads. A hashed file never
+// changes, so browsers and the service worker can cache it for good; only the
+// small manifest is revalidated. Replaced copies of the same module are removed.
+//   node scripts/wasm-publish.mjs <module>...
+
+const BUILD_DIR = resolve("wasm_build");
+const PUBLIC_DIR = resolve("public/wasm");
+const MANIFEST = resolve(PUBLIC_DIR, "manifest.json");
+
+function hashed(name, ext, bytes) {
+  const hash = createHash("sha256").update(bytes).digest("hex").slice(0, 8);
+  return `${name}.${hash}.${ext}`;
+}
+
+export function publish(names) {
+  mkdirSync(PUBLIC_DIR, { recursive: true });
+  const manifest = existsSync(MANIFEST) ? JSON.parse(readFileSync(MANIFEST, "utf8")) : {};
+  for (const name of names) {
+    const js = readFileSync(resolve(BUILD_DIR, `${name}.js`));
+    const wasm = readFileSync(resolve(BUILD_DIR, `${name}.wasm`));
+    const entry = { js: hashed(name, "js", js), wasm: hashed(name, "wasm", wasm) };
+
+    const stale = new RegExp(`^${name}(\\.[0-9a-f]{8})?\\.(js|wasm)$`);
+    for (const f of readdirSync(PUBLIC_DIR)) {
+      if (stale.test(f) && f !== entry.js && f !== entry.wasm) rmSync(resolve(PUBLIC_DIR, f));
+    }
+    writeFileSync(resolve(PUBLIC_DIR, entry.js), js);
+    writeFileSync(resolve(PUBLIC_DIR, entry.wasm), wasm);
+    manifest[name] = entry;
+  }
+  const sorted = Object.fromEntries(Object.keys(manifest).sort().map((k) => [k, manifest[k]]));
+  writeFileSync(MANIFEST, JSON.stringify(sorted, null, 2) + "\n");
+}
+
+if (process.argv[1] && resolve(process.argv[1]) === fileURLToPath(import.meta.url)) {
+  publish(process.argv.slice(2));
+}
@@ -0,0 +1,126 @@
+import { existsSync, readFileSync } from "fs";
+import { resolve } from "path";
+import { pathToFileURL } from "url";
+import { spawn } from "child_process";
+import { performance } from "perf_hooks";
+import { gzipSync } from "zlib";
+
+// Compares the per-game WASM build against the combined ArcadeCore module:
+// bytes on disk and gzipped, and cold start measured in a fresh Node process
+// per run the way the browser loader does it (import the ES-module glue,
+// stream-compile the .wasm, instantiate).
+//   node scripts/wasm-size-report.mjs [--runs N]
+// Build both first: `bash make.sh && bash make.sh core`.
+
+const PUBLIC_DIR = resolve("public/wasm");
+const GAMES = Object.keys(
+  JSON.parse(readFileSync(resolve("scripts", "wasm-exports.json"), "utf8"))
+);
+
+// Child mode: one cold start of the glue at argv[3] and the .wasm at argv[4], printed in ms
+async function coldStart(jsPath, wasmPath) {
+  const t0 = performance.now();
+  const { default: factory } = await import(pathToFileURL(jsPath).href);
+  const response = new Response(readFileSync(wasmPath), {
+    headers: { "content-type": "application/wasm" },
+  });
+  const wasmModule = await WebAssembly.compileStreaming(response);
+  await new Promise((resolvePromise, reject) => {
+    factory({
+      instantiateWasm: (imports, receive) => {
+        WebAssembly.instantiate(wasmModule, imports).then(
+          (instance) => receive(instance, wasmModule),
+          reject
+        );
+        return {};
+      },
+    }).then(resolvePromise, reject);
+  });
+  return performance.now() - t0;
+}
+
+function run(args) {
+  return new Promise((resolvePromise, reject) => {
+    const child = spawn(process.execPath, args, { stdio: ["ignore", "pipe", "inherit"] });
+    let stdout = "";
+    child.stdout.on("data", (d) => (stdout += d));
+    child.on("close", (code) => {
+      if (code === 0) resolvePromise(stdout);
+      else reject(new Error(`cold start run failed with code ${code}`));
+    });
+  });
+}
+
+async function medianColdStart(jsPath, wasmPath, runs) {
+  const times = [];
+  for (let i = 0; i < runs; i++) {
+    times.push(parseFloat(await run([process.argv[1], "--cold", jsPath, wasmPath])));
+  }
+  times.sort((a, b) => a - b);
+  return times[Math.floor(times.length / 2)];
+}
+
+async function measure(manifest, name, runs) {
+  const entry = manifest[name];
+  const js = entry && resolve(PUBLIC_DIR, entry.js);
+  const wasm = entry && resolve(PUBLIC_DIR, entry.wasm);
+  if (!entry || !existsSync(js) || !existsSync(wasm)) {
+    throw new Error(`${name} not published to ${PUBLIC_DIR}; run \`bash make.sh && bash make.sh core\``);
+  }
+  const jsBytes = readFileSync(js);
+  const wasmBytes = readFileSync(wasm);
+  return {
+    js_bytes: jsBytes.length,
+    wasm_bytes: wasmBytes.length,
+    gzip_bytes: gzipSync(jsBytes, { level: 9 }).length + gzipSync(wasmBytes, { level: 9 }).length,
+    cold_start_ms: +(await medianColdStart(js, wasm, runs)).toFixed(2),
+  };
+}
+
+async function main() {
+  const args = process.argv.slice(2);
+  if (args[0] === "--cold") {
+    process.stdout.write(String(await coldStart(resolve(args[1]), resolve(args[2]))));
+    return;
+  }
+  const runsArg = args.indexOf("--runs");
+  const runs = runsArg >= 0 ? Math.max(1, parseInt(args[runsArg + 1], 10) || 1) : 5;
+
+  const manifestPath = resolve(PUBLIC_DIR, "manifest.json");
+  const manifest = existsSync(manifestPath) ? JSON.parse(readFileSync(manifestPath, "utf8")) : {};
+  const modules = {};
+  for (const game of GAMES) {
+    console.error(`Measuring ${game}...`);
+    modules[game] = await measure(manifest, game, runs);
+  }
+  console.error("Measuring ArcadeCore...");
+  const core = await measure(manifest, "ArcadeCore", runs);
+
+  // What a player who opens every game once downloads and instantiates
+  const perGame = { modules: GAMES.length, bytes: 0, gzip_bytes: 0, cold_start_ms: 0 };
+  for (const m of Object.values(modules)) {
+    perGame.bytes += m.js_bytes + m.wasm_bytes;
+    perGame.gzip_bytes += m.gzip_bytes;
+    perGame.cold_start_ms += m.cold_start_ms;
+  }
+  perGame.cold_start_ms = +perGame.cold_start_ms.toFixed(2);
+  const coreBytes = core.js_bytes + core.wasm_bytes;
+
+  const report = {
+    runs,
+    per_game: modules,
+    per_game_total: perGame,
+    core: { ...core, bytes: coreBytes },
+    core_vs_per_game: {
+      bytes_ratio: +(coreBytes / perGame.bytes).toFixed(3),
+      gzip_ratio: +(core.gzip_bytes / perGame.gzip_bytes).toFixed(3),
+      cold_start_ratio: +(core.cold_start_ms / perGame.cold_start_ms).toFixed(3),
+    },
+  };
+  process.stdout.write(JSON.stringify(report, null, 2) + "\n");
+}
+
+main().catch((err) => {
+  console.error(err?.message || err);
+  process.exit(1);
+});
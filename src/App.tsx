@@ -1,10 +1,11 @@
-import { useState } from "react";
+import { useEffect, useState } from "react";
 import GuessTheNumberGame from "./components/GuessTheNumberGame";
 import TicTacToeGame from "./components/TicTacToeGame";
 import SnakeGame from "./components/SnakeGame";
 import RockPaperScissorsGame from "./components/RockPaperScissorsGame";
 import PacmanGame from "./components/PacmanGame";
 import FlappyBirdGame from "./components/FlappyBirdGame";
+import { prefetchWasm } from "./hooks/useWasmLoader";
 
 type GameType =
   | "menu"
@@ -15,9 +16,53 @@ type GameType =
   | "pacman"
   | "flappy";
 
+// WASM module behind each game, for prefetching from the menu
+const GAME_MODULES: Record<Exclude<GameType, "menu">, string> = {
+  guess: "GuessTheNumber",
+  tictactoe: "TicTacToe",
+  snake: "Snake",
+  rps: "RockPaperScissors",
+  pacman: "Pacman",
+  flappy: "FlappyBird",
+};
+
+const LAST_GAME_KEY = "arcade_last_game";
+
 export default function App() {
   const [currentGame, setCurrentGame] = useState<GameType>("menu");
 
+  // On the menu, fetch and compile the game played last while the browser is
+  // idle; hovering or focusing a card fetches that one, so the module is
+  // usually compiled before the click lands.
+  useEffect(() => {
+    if (currentGame !== "menu") return;
+    let last: string | null = null;
+    try {
+      last = localStorage.getItem(LAST_GAME_KEY);
+    } catch {
+      // storage unavailable: nothing to predict
+    }
+    if (!last || !(last in GAME_MODULES)) return;
+    const name = GAME_MODULES[last as keyof typeof GAME_MODULES];
+    const idle = window.requestIdleCallback ?? ((cb: () => void) => window.setTimeout(cb, 200));
+    const cancel = window.cancelIdleCallback ?? window.clearTimeout;
+    const handle = idle(() => prefetchWasm(name));
+    return () => cancel(handle);
+  }, [currentGame]);
+
+  const gameCard = (game: keyof typeof GAME_MODULES) => ({
+    onClick: () => {
+      try {
+        localStorage.setItem(LAST_GAME_KEY, game);
+      } catch {
+        // storage unavailable: skip the prediction
+      }
+      setCurrentGame(game);
+    },
+    onPointerEnter: () => prefetchWasm(GAME_MODULES[game]),
+    onFocus: () => prefetchWasm(GAME_MODULES[game]),
+  });
+
   const Header = (
     <header className="fixed top-0 left-0 right-0 z-20 bg-gradient-to-r from-indigo-700/80 via-purple-700/80 to-fuchsia-700/80 shadow-lg backdrop-blur">
       <div className="max-w-7xl mx-auto w-full flex items-center justify-between px-4 md:px-6 py-3">
@@ -133,7 +178,7 @@ export default function App() {
         {/* Games Grid */}
         <div className="grid grid-cols-1 sm:grid-cols-2 lg:grid-cols-3 gap-6">
           <button
-            onClick={() => setCurrentGame("guess")}
+            {...gameCard("guess")}
             className="group relative overflow-hidden rounded-2xl bg-gradient-to-br from-sky-500 to-blue-600 text-white px-8 py-8 text-left shadow-xl hover:shadow-2xl transition-all duration-200 transform hover:-translate-y-1 focus:ring-4 focus:ring-sky-400/40"
           >
             <div className="flex items-center justify-between">
@@ -148,7 +193,7 @@ export default function App() {
           </button>
 
           <button
-            onClick={() => setCurrentGame("tictactoe")}
+            {...gameCard("tictactoe")}
             className="group relative overflow-hidden rounded-2xl bg-gradient-to-br from-emerald-500 to-green-600 text-white px-8 py-8 text-left shadow-xl hover:shadow-2xl transition-all duration-200 transform hover:-translate-y-1 focus:ring-4 focus:ring-emerald-400/40"
           >
             <div className="flex items-center justify-between">
@@ -163,7 +208,7 @@ export default function App() {
           </button>
 
           <button
-            onClick={() => setCurrentGame("snake")}
+            {...gameCard("snake")}
             className="group relative overflow-hidden rounded-2xl bg-gradient-to-br from-fuchsia-500 to-purple-600 text-white px-8 py-8 text-left shadow-xl hover:shadow-2xl transition-all duration-200 transform hover:-translate-y-1 focus:ring-4 focus:ring-fuchsia-400/40"
           >
             <div className="flex items-center justify-between">
@@ -178,7 +223,7 @@ export default function App() {
           </button>
 
           <button
-            onClick={() => setCurrentGame("rps")}
+            {...gameCard("rps")}
             className="group relative overflow-hidden rounded-2xl bg-gradient-to-br from-orange-500 to-red-600 text-white px-8 py-8 text-left shadow-xl hover:shadow-2xl transition-all duration-200 transform hover:-translate-y-1 focus:ring-4 focus:ring-orange-400/40"
           >
             <div className="flex items-center justify-between">
@@ -193,7 +238,7 @@ export default function App() {
           </button>
 
           <button
-            onClick={() => setCurrentGame("pacman")}
+            {...gameCard("pacman")}
             className="group relative overflow-hidden rounded-2xl bg-gradient-to-br from-yellow-400 to-amber-500 text-white px-8 py-8 text-left shadow-xl hover:shadow-2xl transition-all duration-200 transform hover:-translate-y-1 focus:ring-4 focus:ring-amber-300/40"
           >
             <div className="flex items-center justify-between">
@@ -208,7 +253,7 @@ export default function App() {
           </button>
 
           <button
-            onClick={() => setCurrentGame("flappy")}
+            {...gameCard("flappy")}
             className="group relative overflow-hidden rounded-2xl bg-gradient-to-br from-cyan-500 to-sky-600 text-white px-8 py-8 text-left shadow-xl hover:shadow-2xl transition-all duration-200 transform hover:-translate-y-1 focus:ring-4 focus:ring-cyan-300/40"
           >
             <div className="flex items-center justify-between">
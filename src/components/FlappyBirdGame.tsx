@@ -1,14 +1,14 @@
 import { useCallback, useEffect, useRef, useState } from "react";
 import GameContainer from "./GameContainer";
 import "../styles/Games.css";
-import { useWasmLoader } from "../hooks/useWasmLoader";
-import type { WasmModule } from "../types/wasm.js";
+import { useEngineWorker } from "../hooks/useEngineWorker";
+import { now, type Frame } from "../wasm/channel";
+import { FLAPPY_STATUS, INPUT, STATUS } from "../wasm/protocol";
 
 const BIRD_X = 6;
-const SIM_STEP_MS = 20;
 
 export default function FlappyBirdGame({ onBack }: { onBack: () => void }) {
-  const { wasmRef, isLoaded, error } = useWasmLoader("FlappyBird");
+  const { ready: isLoaded, error, start, input, readFrame } = useEngineWorker("FlappyBird");
   const [width, setWidth] = useState(28);
   const [height, setHeight] = useState(20);
   const [score, setScore] = useState(0);
@@ -17,19 +17,19 @@ export default function FlappyBirdGame({ onBack }: { onBack: () => void }) {
   const [bestScore, setBestScore] = useState(0);
   const [gameError, setGameError] = useState<string | null>(null);
   const rafRef = useRef<number | null>(null);
-  const lastTsRef = useRef<number>(0);
-  const accRef = useRef<number>(0);
   const boardWrapRef = useRef<HTMLDivElement | null>(null);
   const canvasRef = useRef<HTMLCanvasElement | null>(null);
 
-  const drawFrame = useCallback(() => {
-    const mod: WasmModule | null = wasmRef.current;
+  // alpha: how far between the last two simulation steps this frame falls
+  const drawFrame = useCallback((frame: Frame, alpha: number) => {
     const canvas = canvasRef.current;
     const wrap = boardWrapRef.current;
-    if (!mod || !canvas || !wrap) return;
+    if (!canvas || !wrap) return;
 
-    const w = mod._flappy_get_width?.() ?? 28;
-    const h = mod._flappy_get_height?.() ?? 20;
+    const status = frame.status;
+    const w = status[STATUS.WIDTH] || 28;
+    const h = status[STATUS.HEIGHT] || 20;
+    const fpOne = status[FLAPPY_STATUS.FP_ONE] || 65536;
 
     const wrapWidth = wrap.clientWidth || 1;
     const cssWidth = Math.max(1, wrapWidth);
@@ -57,18 +57,27 @@ export default function FlappyBirdGame({ onBack }: { onBack: () => void }) {
     ctx.fillStyle = "#38bdf8";
     ctx.fillRect(0, 0, cssWidth, cssHeight);
 
+    // Pipes from the engine's entity export: [birdY, count, (x, gapY, gapHeight)...]
+    // with fixed-point x, drawn at sub-cell positions
     ctx.fillStyle = "#047857";
-    for (let i = 0; i < w * h; i++) {
-      const code = mod._flappy_get_cell?.(i) ?? 0;
-      const ch = code > 0 ? String.fromCharCode(code) : "";
-      if (ch === "#") {
-        const x = i % w;
-        const y = Math.floor(i / w);
-        ctx.fillRect(x * cellW, y * cellH, cellW, cellH);
+    if (frame.payloadLength >= 8) {
+      const entities = new Int32Array(frame.payload.buffer, 0, frame.payloadLength >> 2);
+      // Pipes all scroll together, so one offset places them at alpha
+      const scroll = (status[FLAPPY_STATUS.SCROLL] / fpOne) * (1 - alpha);
+      const count = entities[1];
+      for (let i = 0; i < count; i++) {
+        const e = 2 + i * 3;
+        const px = (entities[e] / fpOne + scroll) * cellW;
+        if (px >= cssWidth || px + cellW <= 0) continue;
+        const gapTop = entities[e + 1] * cellH;
+        const gapBottom = (entities[e + 1] + entities[e + 2]) * cellH;
+        ctx.fillRect(px, 0, cellW, gapTop);
+        ctx.fillRect(px, gapBottom, cellW, cssHeight - gapBottom);
       }
     }
 
-    const birdY = mod._flappy_get_bird_y?.() ?? h / 2;
+    const prevY = status[FLAPPY_STATUS.BIRD_Y_PREV];
+    const birdY = (prevY + (status[FLAPPY_STATUS.BIRD_Y] - prevY) * alpha) / fpOne;
     const bx = (BIRD_X + 0.5) * cellW;
     const by = (birdY + 0.5) * cellH;
     const radius = Math.max(3, Math.min(cellW, cellH) * 0.38);
@@ -85,45 +94,24 @@ export default function FlappyBirdGame({ onBack }: { onBack: () => void }) {
 
     if (w !== width) setWidth(w);
     if (h !== height) setHeight(h);
-  }, [height, wasmRef, width]);
-
-  const syncStatus = useCallback(() => {
-    try {
-      const mod: WasmModule | null = wasmRef.current;
-      if (!mod) return;
-      setScore(mod._flappy_get_score?.() ?? 0);
-      setHasStarted(!!(mod._flappy_has_started?.() ?? 0));
-      setGameOver(!!(mod._flappy_is_game_over?.() ?? 0));
-    } catch (err) {
-      setGameError(String(err));
-    }
-  }, [wasmRef]);
+  }, [height, width]);
 
   const startGame = useCallback(() => {
-    try {
-      const mod: WasmModule | null = wasmRef.current;
-      if (!mod?._flappy_start_game) return;
-      mod._flappy_start_game();
-      setGameOver(false);
-      setHasStarted(false);
-      setScore(0);
-      setGameError(null);
-      syncStatus();
-      drawFrame();
-    } catch (err) {
-      setGameError(String(err));
-    }
-  }, [drawFrame, syncStatus, wasmRef]);
+    start();
+    setGameOver(false);
+    setHasStarted(false);
+    setScore(0);
+    setGameError(null);
+  }, [start]);
 
   const triggerFlap = useCallback(() => {
-    const mod: WasmModule | null = wasmRef.current;
-    if (!mod) return;
+    if (!isLoaded) return;
     if (gameOver) {
       startGame();
       return;
     }
-    mod._flappy_flap?.();
-  }, [gameOver, startGame, wasmRef]);
+    input(INPUT.FLAP);
+  }, [gameOver, input, isLoaded, startGame]);
 
   useEffect(() => {
     if (!isLoaded) return;
@@ -140,45 +128,38 @@ export default function FlappyBirdGame({ onBack }: { onBack: () => void }) {
   useEffect(() => {
     if (!isLoaded) return;
 
-    const loop = (ts: number) => {
+    let lastSeq = 0;
+    const loop = () => {
       try {
-        const mod: WasmModule | null = wasmRef.current;
-
-        if (!lastTsRef.current) {
-          lastTsRef.current = ts;
-        }
-
-        const delta = ts - lastTsRef.current;
-        lastTsRef.current = ts;
-        accRef.current += Math.min(delta, 100);
-
-        while (accRef.current >= SIM_STEP_MS) {
-          if (mod?._flappy_update) {
-            mod._flappy_update();
-          } else if (mod?._flappy_tick) {
-            mod._flappy_tick();
-          }
-          accRef.current -= SIM_STEP_MS;
-        }
-
-        drawFrame();
-        syncStatus();
-
-        const over = !!(mod?._flappy_is_game_over?.() ?? 0);
-        if (over) {
-          const s = mod?._flappy_get_score?.() ?? 0;
-          setGameOver(true);
-          setScore(s);
-          setBestScore((prev) => {
-            const next = s > prev ? s : prev;
-            try {
-              if (next > prev)
-                localStorage.setItem("flappy_best", String(next));
-            } catch (err) {
-              console.error("Game update error:", err);
+        const frame = readFrame();
+        if (frame) {
+          // The engine steps in its worker at a fixed rate and stamps each
+          // frame with when its step was due; how far the display has moved
+          // past that picks the blend, so any display rate renders smoothly
+          const stepMs = frame.status[STATUS.STEP_MS] || 20;
+          const over = !!frame.status[STATUS.GAME_OVER];
+          const alpha = over ? 1 : Math.min(1, Math.max(0, (now() - frame.time) / stepMs));
+          drawFrame(frame, alpha);
+
+          if (frame.seq !== lastSeq) {
+            lastSeq = frame.seq;
+            const s = frame.status[STATUS.SCORE];
+            setScore(s);
+            setHasStarted(!!frame.status[FLAPPY_STATUS.STARTED]);
+            setGameOver(over);
+            if (over) {
+              setBestScore((prev) => {
+                const next = s > prev ? s : prev;
+                try {
+                  if (next > prev)
+                    localStorage.setItem("flappy_best", String(next));
+                } catch (err) {
+                  console.error("Game update error:", err);
+                }
+                return next;
+              });
             }
-            return next;
-          });
+          }
         }
       } catch (err) {
         setGameError(String(err));
@@ -193,10 +174,8 @@ export default function FlappyBirdGame({ onBack }: { onBack: () => void }) {
         cancelAnimationFrame(rafRef.current);
       }
       rafRef.current = null;
-      lastTsRef.current = 0;
-      accRef.current = 0;
     };
-  }, [drawFrame, isLoaded, syncStatus, wasmRef]);
+  }, [drawFrame, isLoaded, readFrame]);
 
   if (error) {
     return (
@@ -82,9 +82,9 @@ export default function GuessTheNumberGame({ onBack }: { onBack: () => void }) {
   const handleClear = () => setGuess("");
 
   const startGame = () => {
-    if (wasmRef.current && wasmRef.current._start_game) {
-      wasmRef.current._set_hint_difficulty?.(hintLevel);
-      wasmRef.current._start_game(max);
+    if (wasmRef.current && wasmRef.current._guess_start_game) {
+      wasmRef.current._guess_set_hint_difficulty?.(hintLevel);
+      wasmRef.current._guess_start_game(max);
       setGameStarted(true);
       setFeedback(
         `Game started. Hint metric: distance ratio = |guess - secret| / (${max} - 1).`
@@ -99,10 +99,10 @@ export default function GuessTheNumberGame({ onBack }: { onBack: () => void }) {
       setFeedback(`Please enter a valid number between 1 and ${max}.`);
       return;
     }
-    if (wasmRef.current._make_guess_hint) {
-      const hintCode = wasmRef.current._make_guess_hint(num);
+    if (wasmRef.current._guess_make_guess_hint) {
+      const hintCode = wasmRef.current._guess_make_guess_hint(num);
       if (hintCode === 0) {
-        const attempts = wasmRef.current._get_attempts?.();
+        const attempts = wasmRef.current._guess_get_attempts?.();
         setFeedback(
           attempts
             ? `🎉 Correct! You got it in ${attempts} attempts!`
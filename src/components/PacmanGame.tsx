@@ -1,7 +1,10 @@
 import { useEffect, useRef, useState, useCallback } from "react";
 import GameContainer from "./GameContainer";
-import { useWasmLoader } from "../hooks/useWasmLoader";
-import type { WasmModule } from "../types/wasm.js";
+import { useEngineWorker } from "../hooks/useEngineWorker";
+import { useTileRenderer } from "../hooks/useTileRenderer";
+import { TILE } from "../render/tiles";
+import type { BoardStyle } from "../render/tileRenderer";
+import { INPUT, PACMAN_STATUS, STATUS } from "../wasm/protocol";
 import "../styles/Games.css";
 
 const DIRS: Record<string, number> = {
@@ -19,58 +22,54 @@ const DIRS: Record<string, number> = {
   A: 3,
 };
 
-// Default level used internally in WASM; UI has no difficulty controls.
-const DEFAULT_LEVEL = 2;
+const FLOOR = "#1f2937";
+const BOARD: BoardStyle = {
+  palette: {
+    [TILE.EMPTY]: { color: FLOOR },
+    [TILE.WALL]: { color: "#1d4ed8" },
+    [TILE.PELLET]: { color: "#fcd34d", dot: 0.3, background: FLOOR },
+    [TILE.POWER_PELLET]: { color: "#fcd34d", dot: 0.65, background: FLOOR },
+    [TILE.PACMAN]: { color: "#fde047" },
+    [TILE.GHOST]: { color: "#f87171" },
+  },
+  background: "#111827",
+  gap: 1,
+  radius: 2,
+};
 
 export default function PacmanGame({ onBack }: { onBack: () => void }) {
-  const { wasmRef, isLoaded, error } = useWasmLoader("Pacman");
+  const { ready: isLoaded, error, start, input, readFrame } = useEngineWorker("Pacman");
   const [gameOver, setGameOver] = useState(false);
   const [started, setStarted] = useState(false);
   const [score, setScore] = useState(0);
-  const [width, setWidth] = useState(28);
-  const [board, setBoard] = useState<(string | number)[]>([]);
+  const [pellets, setPellets] = useState(0);
+  const { canvasRef, draw } = useTileRenderer(BOARD);
   const [gameError, setGameError] = useState<string | null>(null);
-  const tickRef = useRef<number | null>(null);
+  const lastSeqRef = useRef(0);
   const touchStart = useRef<{ x: number; y: number } | null>(null);
 
   const readBoard = useCallback(() => {
     try {
-      const mod: WasmModule | null = wasmRef.current;
-      if (!mod) return;
-      const w = mod._pacman_get_width?.() ?? 19;
-      const h = mod._pacman_get_height?.() ?? 21;
-      setWidth(w);
-      const cells: (string | number)[] = [];
-      if (mod._pacman_get_cell) {
-        for (let i = 0; i < w * h; i++) {
-          const v = mod._pacman_get_cell(i);
-          const char = v > 0 ? String.fromCharCode(v) : "";
-          cells.push(char);
-        }
-      }
-      setBoard(cells);
-      setScore(mod._pacman_get_score?.() ?? 0);
-      setGameOver(!!(mod._pacman_is_game_over?.() ?? 0));
+      const frame = readFrame();
+      if (!frame || frame.seq === lastSeqRef.current) return;
+      lastSeqRef.current = frame.seq;
+      draw(frame.payload, frame.status[STATUS.WIDTH], frame.status[STATUS.HEIGHT]);
+      setScore(frame.status[STATUS.SCORE]);
+      setPellets(frame.status[PACMAN_STATUS.PELLETS]);
+      setGameOver(!!frame.status[STATUS.GAME_OVER]);
     } catch (err) {
       console.error("[PACMAN] readBoard error:", err);
       setGameError(String(err));
     }
-  }, [wasmRef]);
+  }, [draw, readFrame]);
 
   const startGame = useCallback(() => {
-    try {
-      const mod: WasmModule | null = wasmRef.current;
-      if (!mod?._pacman_start_game) return;
-      mod._pacman_start_game(DEFAULT_LEVEL);
-      setGameOver(false);
-      setStarted(true);
-      setScore(0);
-      setGameError(null);
-      readBoard();
-    } catch (err) {
-      setGameError(String(err));
-    }
-  }, [readBoard, wasmRef]);
+    start();
+    setGameOver(false);
+    setStarted(true);
+    setScore(0);
+    setGameError(null);
+  }, [start]);
 
   // Do not auto-start; wait for user input
 
@@ -79,84 +78,23 @@ export default function PacmanGame({ onBack }: { onBack: () => void }) {
       const dir = DIRS[e.key];
       if (dir !== undefined) {
         e.preventDefault();
-        const mod: WasmModule | null = wasmRef.current;
         if (!started || gameOver) return;
-        if (mod?._pacman_set_direction) mod._pacman_set_direction(dir);
+        input(INPUT.DIRECTION, dir);
       }
     };
     window.addEventListener("keydown", onKey);
     return () => window.removeEventListener("keydown", onKey);
-  }, [wasmRef, started, gameOver, startGame]);
+  }, [input, started, gameOver]);
 
+  // The engine ticks in its worker; draw whatever it published last
   useEffect(() => {
-    if (!isLoaded || !started || gameOver) return;
-
-    if (tickRef.current !== null) {
-      window.clearInterval(tickRef.current);
-      tickRef.current = null;
-    }
-
-    tickRef.current = window.setInterval(() => {
-      try {
-        const mod: WasmModule | null = wasmRef.current;
-        if (mod?._pacman_update) mod._pacman_update();
-        else if (mod?._pacman_tick) mod._pacman_tick();
-        readBoard();
-      } catch (err) {
-        console.error("[PACMAN] renderLoop error:", err);
-        setGameError(String(err));
-      }
-    }, 90);
-
-    return () => {
-      if (tickRef.current !== null) {
-        window.clearInterval(tickRef.current);
-        tickRef.current = null;
-      }
-    };
-  }, [isLoaded, readBoard, wasmRef, started, gameOver]);
-
-  const classifyCell = (raw: string | number): string => {
-    let char = "";
-    if (typeof raw === "number") char = raw > 0 ? String.fromCharCode(raw) : "";
-    else char = String(raw);
-    if (char === "#") return "wall";
-    if (char === ".") return "pellet";
-    if (char === "o") return "power";
-    if (char === "P") return "pacman";
-    if (char === "G") return "ghost";
-    return "empty";
-  };
-
-  const renderCell = (kind: string, i: number) => {
-    if (kind === "pellet") {
-      return (
-        <div key={i} className="relative aspect-square bg-gray-800 rounded-sm">
-          <div className="absolute inset-0 flex items-center justify-center">
-            <div className="w-1.5 h-1.5 bg-amber-300 rounded-full shadow" />
-          </div>
-        </div>
-      );
-    }
-    if (kind === "power") {
-      return (
-        <div key={i} className="relative aspect-square bg-gray-800 rounded-sm">
-          <div className="absolute inset-0 flex items-center justify-center">
-            <div className="w-3 h-3 bg-amber-300 rounded-full shadow" />
-          </div>
-        </div>
-      );
-    }
-    const cls =
-      kind === "wall"
-        ? "bg-blue-700"
-        : kind === "pacman"
-        ? "bg-yellow-300"
-        : kind === "ghost"
-        ? "bg-red-400"
-        : "bg-gray-800";
-    return <div key={i} className={`aspect-square rounded-sm ${cls}`} />;
-  };
+    if (!isLoaded) return;
+    let raf = requestAnimationFrame(function loop() {
+      readBoard();
+      raf = requestAnimationFrame(loop);
+    });
+    return () => cancelAnimationFrame(raf);
+  }, [isLoaded, readBoard]);
 
   const onTouchStart = (e: React.TouchEvent) => {
     const t = e.touches[0];
@@ -169,12 +107,11 @@ export default function PacmanGame({ onBack }: { onBack: () => void }) {
     const dy = t.clientY - touchStart.current.y;
     touchStart.current = null;
     if (Math.abs(dx) < 12 && Math.abs(dy) < 12) return; // ignore tiny moves
-    const mod: WasmModule | null = wasmRef.current;
-    if (!mod?._pacman_set_direction || !started || gameOver) return;
+    if (!started || gameOver) return;
     if (Math.abs(dx) > Math.abs(dy)) {
-      mod._pacman_set_direction(dx > 0 ? 1 : 3);
+      input(INPUT.DIRECTION, dx > 0 ? 1 : 3);
     } else {
-      mod._pacman_set_direction(dy > 0 ? 2 : 0);
+      input(INPUT.DIRECTION, dy > 0 ? 2 : 0);
     }
   };
 
@@ -228,6 +165,11 @@ export default function PacmanGame({ onBack }: { onBack: () => void }) {
           <div className="px-3 py-1 rounded-lg bg-yellow-500 shadow">
             Score: {score}
           </div>
+          {started && (
+            <div className="px-3 py-1 rounded-lg bg-gray-700 shadow">
+              Pellets: {pellets}
+            </div>
+          )}
           {gameOver && (
             <div className="px-3 py-1 rounded-lg bg-red-600 shadow">
               Game Over
@@ -242,13 +184,11 @@ export default function PacmanGame({ onBack }: { onBack: () => void }) {
         </div>
 
         <div
-          className={`relative pacman-board ${
-            width === 28 ? "pacman-board-cols-28" : ""
-          }`}
+          className="relative pacman-board"
           onTouchStart={onTouchStart}
           onTouchEnd={onTouchEnd}
         >
-          {board.map((v, i) => renderCell(classifyCell(v), i))}
+          <canvas ref={canvasRef} className="tile-canvas" />
         </div>
 
         {gameOver && (
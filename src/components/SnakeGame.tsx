@@ -1,7 +1,10 @@
 import { useEffect, useRef, useState, useCallback } from "react";
 import GameContainer from "./GameContainer";
-import { useWasmLoader } from "../hooks/useWasmLoader";
-import type { WasmModule } from "../types/wasm";
+import { useEngineWorker } from "../hooks/useEngineWorker";
+import { useTileRenderer } from "../hooks/useTileRenderer";
+import { TILE } from "../render/tiles";
+import type { BoardStyle } from "../render/tileRenderer";
+import { INPUT, STATUS } from "../wasm/protocol";
 import "../styles/Games.css";
 
 // Directions expected by WASM: 0=Up, 1=Right, 2=Down, 3=Left
@@ -20,88 +23,67 @@ const DIRS: Record<string, number> = {
   A: 3,
 };
 
+const BOARD: BoardStyle = {
+  palette: {
+    [TILE.EMPTY]: { color: "#374151" },
+    [TILE.SNAKE]: { color: "#34d399" },
+    [TILE.FOOD]: { color: "#f59e0b" },
+  },
+  background: "#111827",
+  gap: 1,
+  radius: 2,
+};
+
 export default function SnakeGame({ onBack }: { onBack: () => void }) {
-  const { wasmRef, isLoaded, error } = useWasmLoader("Snake");
+  const { ready: isLoaded, error, start, input, readFrame } = useEngineWorker("Snake");
   const [gameOver, setGameOver] = useState(false);
   const [started, setStarted] = useState(false);
   const [score, setScore] = useState(0);
-  const [width, setWidth] = useState(20);
-  const [moveIntervalMs, setMoveIntervalMs] = useState(150);
-  // height is currently fixed by WASM and not used in layout classes
-  const [board, setBoard] = useState<(string | number)[]>([]);
+  const { canvasRef, draw } = useTileRenderer(BOARD);
   const [gameError, setGameError] = useState<string | null>(null);
   const [focusMode, setFocusMode] = useState(false);
-  const tickRef = useRef<number | null>(null);
+  const lastSeqRef = useRef(0);
   const touchStartRef = useRef<{ x: number; y: number } | null>(null);
 
-  // Minimal board reader - just display what C++ gives us
+  // Minimal board reader - just display the newest frame the engine worker published
   const readBoard = useCallback(() => {
     try {
-      const mod = wasmRef.current;
-      if (!mod) return;
-
-      const w = mod._snake_get_width?.() ?? 20;
-      const h = mod._snake_get_height?.() ?? 20;
-      setWidth(w);
-      // height (h) is provided by WASM but not needed for grid styling
-
-      const cells: (string | number)[] = [];
-      if (mod._snake_get_cell) {
-        for (let i = 0; i < w * h; i++) {
-          const v = mod._snake_get_cell(i);
-          const char = v > 0 ? String.fromCharCode(v) : "";
-          cells.push(char);
-        }
-      }
-      setBoard(cells);
+      const frame = readFrame();
+      if (!frame || frame.seq === lastSeqRef.current) return;
+      lastSeqRef.current = frame.seq;
 
-      // Get game state
-      const newScore = mod._snake_get_score?.() ?? 0;
-      const newGameOver = !!(mod._snake_is_game_over?.() ?? 0);
-
-      setScore(newScore);
-      setGameOver(newGameOver);
+      draw(frame.payload, frame.status[STATUS.WIDTH], frame.status[STATUS.HEIGHT]);
+      setScore(frame.status[STATUS.SCORE]);
+      setGameOver(!!frame.status[STATUS.GAME_OVER]);
     } catch (err) {
       console.error("Error in readBoard:", err);
       setGameError(`Board read error: ${err}`);
     }
-  }, [wasmRef]);
+  }, [draw, readFrame]);
 
   const startGame = useCallback(() => {
-    try {
-      const mod: WasmModule | null = wasmRef.current;
-      if (!mod?._snake_start_game) return;
-      mod._snake_set_difficulty?.(2);
-      mod._snake_start_game();
-      setGameOver(false);
-      setStarted(true);
-      setScore(0);
-      setGameError(null);
-      setMoveIntervalMs(mod._snake_get_move_interval_ms?.() ?? 150);
-      readBoard();
-    } catch (err) {
-      console.error("Error in startGame:", err);
-      setGameError(`Game start error: ${err}`);
-    }
-  }, [readBoard, wasmRef]);
+    start();
+    setGameOver(false);
+    setStarted(true);
+    setScore(0);
+    setGameError(null);
+  }, [start]);
 
   const applyDirection = useCallback(
     (dir: number) => {
-      const mod = wasmRef.current;
-      if (!mod) return;
       if (!started || gameOver) return;
-      mod._snake_set_direction?.(dir);
+      input(INPUT.DIRECTION, dir);
     },
-    [gameOver, started, wasmRef]
+    [gameOver, input, started]
   );
 
   // Do not auto-start. Wait for user input (click or key press).
 
-  // Simple input - just pass to C++, let C++ handle everything
+  // Simple input - queue it for the engine, which applies it at its next step
   useEffect(() => {
     const onKey = (e: KeyboardEvent) => {
       const dir = DIRS[e.key];
-      if (!wasmRef.current) return;
+      if (!isLoaded) return;
 
       // Start or restart on any movement key
       if (dir !== undefined) {
@@ -112,36 +94,18 @@ export default function SnakeGame({ onBack }: { onBack: () => void }) {
 
     window.addEventListener("keydown", onKey);
     return () => window.removeEventListener("keydown", onKey);
-  }, [applyDirection, wasmRef]);
+  }, [applyDirection, isLoaded]);
 
-  // Stable fixed-step loop driven by JS to avoid mixed timing jitter.
+  // The engine steps in its worker at its own rate; each animation frame
+  // only picks up whatever it published last.
   useEffect(() => {
-    if (!isLoaded || !started || gameOver) return;
-
-    if (tickRef.current !== null) {
-      window.clearInterval(tickRef.current);
-      tickRef.current = null;
-    }
-
-    tickRef.current = window.setInterval(() => {
-      try {
-        const mod = wasmRef.current;
-        if (mod?._snake_update) mod._snake_update();
-        else if (mod?._snake_tick) mod._snake_tick();
-        readBoard();
-      } catch (err) {
-        console.error("Error in render loop:", err);
-        setGameError(`Render error: ${err}`);
-      }
-    }, moveIntervalMs);
-
-    return () => {
-      if (tickRef.current !== null) {
-        window.clearInterval(tickRef.current);
-        tickRef.current = null;
-      }
-    };
-  }, [isLoaded, gameOver, moveIntervalMs, readBoard, started, wasmRef]);
+    if (!isLoaded) return;
+    let raf = requestAnimationFrame(function loop() {
+      readBoard();
+      raf = requestAnimationFrame(loop);
+    });
+    return () => cancelAnimationFrame(raf);
+  }, [isLoaded, readBoard]);
 
   // Focus mode turns snake into a dedicated play window and prevents page scroll.
   useEffect(() => {
@@ -164,27 +128,9 @@ export default function SnakeGame({ onBack }: { onBack: () => void }) {
     };
   }, [focusMode]);
 
-  const classifyCell = (raw: string | number): string => {
-    // Convert to string if it's a number (character code)
-    let char = "";
-    if (typeof raw === "number") {
-      char = raw > 0 ? String.fromCharCode(raw) : "";
-    } else {
-      char = String(raw);
-    }
-
-    // Check for snake, food, and empty
-    if (char === "S") return "snake";
-    if (char === "F") return "food";
-    if (char === " " || char === "" || char.trim() === "") return "empty";
-
-    // Fallback for any unexpected values
-    return "empty";
-  };
-
   const boardView = (
     <div
-      className={`relative snake-board ${width === 20 ? "snake-board-cols-20" : ""}`}
+      className="relative snake-board"
       onTouchStart={(e) => {
         e.preventDefault();
         if (e.touches[0]) {
@@ -215,22 +161,7 @@ export default function SnakeGame({ onBack }: { onBack: () => void }) {
         touchStartRef.current = null;
       }}
     >
-      {board.map((v, i) => {
-        const kind = classifyCell(v);
-        return (
-          <div
-            key={i}
-            className={
-              `aspect-square rounded-sm ` +
-              (kind === "snake"
-                ? "bg-emerald-400"
-                : kind === "food"
-                ? "bg-amber-500"
-                : "bg-gray-700")
-            }
-          />
-        );
-      })}
+      <canvas ref={canvasRef} className="tile-canvas" />
     </div>
   );
 
@@ -304,8 +235,8 @@ export default function SnakeGame({ onBack }: { onBack: () => void }) {
           </button>
         </div>
 
-        {/* Board */}
-        {boardView}
+        {/* Board (moves into the play window while it is open) */}
+        {!focusMode && boardView}
         {gameOver && (
           <div className="w-full max-w-md text-center bg-red-600/90 text-white rounded-xl px-4 py-3 shadow">
             <div className="font-bold text-lg">You Lost</div>
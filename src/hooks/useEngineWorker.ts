@@ -0,0 +1,92 @@
+import { useCallback, useEffect, useRef, useState } from "react";
+import { FrameReader, InputWriter, now, type Frame } from "../wasm/channel";
+import { compileWasmFor, moduleNameFor } from "../wasm/loader";
+import type { EngineGame, FromWorker, ToWorker } from "../wasm/protocol";
+
+// Runs a real-time game's engine in a dedicated worker (see
+// wasm/engine.worker.ts). The component reads the newest frame whenever it
+// draws and pushes input events; neither waits on the other.
+//
+// When the page is cross-origin isolated the frame channel and input ring are
+// SharedArrayBuffers read and written in place. Otherwise (e.g. a host that
+// cannot send COOP/COEP headers) the worker posts a copy of the channel per
+// frame and inputs travel as messages, with the same layouts on both ends.
+export function useEngineWorker(game: EngineGame) {
+  const moduleName = moduleNameFor(game);
+  const workerRef = useRef<Worker | null>(null);
+  const framesRef = useRef<FrameReader | null>(null);
+  const inputsRef = useRef<InputWriter | null>(null);
+  const [ready, setReady] = useState(false);
+  const [error, setError] = useState<string | null>(null);
+
+  useEffect(() => {
+    let active = true;
+    const worker = new Worker(new URL("../wasm/engine.worker.ts", import.meta.url), {
+      type: "module",
+    });
+    workerRef.current = worker;
+
+    const report = (message: string) => {
+      if (!active) return;
+      console.error(`[ENGINE WORKER] ${moduleName}:`, message);
+      setError(message);
+    };
+
+    worker.onmessage = (e: MessageEvent<FromWorker>) => {
+      const msg = e.data;
+      if (msg.type === "ready") {
+        framesRef.current = new FrameReader(msg.frames);
+        inputsRef.current = msg.shared ? new InputWriter(msg.inputs) : null;
+        if (active) setReady(true);
+      } else if (msg.type === "frame") {
+        framesRef.current?.replace(msg.frames);
+      } else if (msg.type === "error") {
+        report(msg.message);
+      }
+    };
+    worker.onerror = (e) => report(e.message || "worker failed to start");
+
+    // The compiled module comes from the page-wide cache (the menu may have
+    // prefetched it); WebAssembly.Modules can be posted to workers
+    compileWasmFor(game).then(
+      (wasmModule) => {
+        const msg: ToWorker = { type: "init", game, wasmModule };
+        worker.postMessage(msg);
+      },
+      (err: unknown) =>
+        report(`Failed to load ${moduleName}: ${err instanceof Error ? err.message : String(err)}`)
+    );
+
+    return () => {
+      active = false;
+      worker.terminate();
+      workerRef.current = null;
+      framesRef.current = null;
+      inputsRef.current = null;
+      setReady(false);
+    };
+  }, [game, moduleName]);
+
+  const post = useCallback((msg: ToWorker) => workerRef.current?.postMessage(msg), []);
+
+  const start = useCallback(() => post({ type: "start" }), [post]);
+
+  const input = useCallback(
+    (code: number, value = 0) => {
+      const time = now();
+      const ring = inputsRef.current;
+      if (ring) {
+        if (!ring.push(code, value, time)) console.warn("[ENGINE WORKER] input ring full, event dropped");
+      } else {
+        post({ type: "input", code, value, time });
+      }
+    },
+    [post]
+  );
+
+  // The newest published frame, or null before the first; compare seq to
+  // skip work when nothing changed since the last call
+  const readFrame = useCallback((): Frame | null => framesRef.current?.read() ?? null, []);
+
+  return { ready, error, start, input, readFrame };
+}
@@ -0,0 +1,36 @@
+import { useCallback, useRef } from "react";
+import { createTileRenderer, type BoardStyle, type TileRenderer } from "../render/tileRenderer";
+
+// Binds a tile renderer (render/tileRenderer.ts) to whichever canvas the
+// component currently mounts. draw() is cheap enough to call on every new
+// engine frame. A canvas that replaces another (e.g. moving the board into an
+// overlay) starts with the last tiles drawn.
+export function useTileRenderer(board: BoardStyle) {
+  const rendererRef = useRef<TileRenderer | null>(null);
+  const lastRef = useRef<TileRenderer | null>(null);
+  const boardRef = useRef(board);
+  boardRef.current = board;
+
+  const canvasRef = useCallback((canvas: HTMLCanvasElement | null) => {
+    if (rendererRef.current) {
+      rendererRef.current.dispose();
+      lastRef.current = rendererRef.current;
+      rendererRef.current = null;
+    }
+    if (!canvas) return;
+    try {
+      const renderer = createTileRenderer(canvas, boardRef.current);
+      const last = lastRef.current;
+      if (last?.cols) renderer.update(last.tiles, last.cols, last.rows);
+      rendererRef.current = renderer;
+    } catch (err) {
+      console.error("[TILE RENDERER] Failed to set up the board canvas:", err);
+    }
+  }, []);
+
+  const draw = useCallback((tiles: Uint8Array, cols: number, rows: number) => {
+    if (cols > 0 && rows > 0) rendererRef.current?.update(tiles, cols, rows);
+  }, []);
+
+  return { canvasRef, draw };
+}
@@ -1,15 +1,19 @@
 import { useEffect, useRef, useState } from "react";
+import { loadWasm, moduleNameFor } from "../wasm/loader";
+
+export { prefetchWasm } from "../wasm/loader";
 
 export interface WasmModule {
   _malloc?: (size: number) => number;
   _free?: (ptr: number) => void;
   HEAPU8?: Uint8Array;
+  HEAP32?: Int32Array;
   // Guess The Number functions
-  _start_game?: (maxNumber: number) => void;
-  _set_hint_difficulty?: (level: number) => void;
-  _make_guess?: (guess: number) => number;
-  _make_guess_hint?: (guess: number) => number;
-  _get_attempts?: () => number;
+  _guess_start_game?: (maxNumber: number) => void;
+  _guess_set_hint_difficulty?: (level: number) => void;
+  _guess_make_guess?: (guess: number) => number;
+  _guess_make_guess_hint?: (guess: number) => number;
+  _guess_get_attempts?: () => number;
   // Tic Tac Toe functions
   _ttt_start_game?: () => void;
   _ttt_get_current_player?: () => number;
@@ -18,16 +22,26 @@ export interface WasmModule {
   _ttt_get_board?: () => number;
   _ttt_check_winner?: () => number;
   _ttt_ai_move?: (difficulty: number) => number;
+  _ttt_configure?: (m: number, n: number, k: number) => number;
+  _ttt_get_width?: () => number;
+  _ttt_get_height?: () => number;
+  _ttt_get_win_length?: () => number;
+  _ttt_set_time_budget_ms?: (ms: number) => void;
   _ttt_reset?: () => void;
   // Snake functions
   _snake_start_game?: () => void;
   _snake_set_direction?: (direction: number) => void;
+  _snake_configure?: (width: number, height: number) => number;
   _snake_tick?: () => number;
   _snake_update?: () => number;
+  _snake_step_n?: (steps: number) => number;
   _snake_get_width?: () => number;
   _snake_get_height?: () => number;
   _snake_get_move_interval_ms?: () => number;
   _snake_get_cell?: (index: number) => number;
+  _snake_get_dirty_count?: () => number;
+  _snake_get_dirty_ptr?: () => number;
+  _snake_clear_dirty?: () => void;
   _snake_get_score?: () => number;
   _snake_is_game_over?: () => number;
 
@@ -50,12 +64,20 @@ export interface WasmModule {
   // Pacman functions
   _pacman_start_game?: (level?: number) => void;
   _pacman_set_direction?: (direction: number) => void;
+  _pacman_set_ghost_count?: (count: number) => number;
   _pacman_tick?: () => number;
   _pacman_update?: () => number;
   _pacman_get_width?: () => number;
   _pacman_get_height?: () => number;
   _pacman_get_cell?: (index: number) => number;
+  _pacman_get_dirty_count?: () => number;
+  _pacman_get_dirty_ptr?: () => number;
+  _pacman_clear_dirty?: () => void;
+  _pacman_debug_get_alloc_count?: () => number;
+  _pacman_get_frame_ptr?: () => number;
+  _pacman_render_frame?: () => number;
   _pacman_get_score?: () => number;
+  _pacman_get_pellets_remaining?: () => number;
   _pacman_is_game_over?: () => number;
 
   // Flappy Bird
@@ -69,131 +91,39 @@ export interface WasmModule {
   _flappy_get_width?: () => number;
   _flappy_get_height?: () => number;
   _flappy_get_cell?: (index: number) => number;
+  _flappy_get_dirty_count?: () => number;
+  _flappy_get_dirty_ptr?: () => number;
+  _flappy_clear_dirty?: () => void;
   _flappy_get_score?: () => number;
   _flappy_is_game_over?: () => number;
 }
 
-export function useWasmLoader(moduleName: string) {
+export function useWasmLoader(gameName: string) {
+  const moduleName = moduleNameFor(gameName);
   const wasmRef = useRef<WasmModule | null>(null);
   const [isLoaded, setIsLoaded] = useState(false);
   const [error, setError] = useState<string | null>(null);
-  // Guard to avoid duplicate loads/instantiation in React StrictMode
-  const loadedRef = useRef(false);
-  type WasmCache = Record<string, WasmModule>;
 
   useEffect(() => {
-    const loadWasm = async () => {
-      try {
-        // Simple cache of instantiated modules keyed by moduleName
-        const g = window as unknown as {
-          __wasmModules?: WasmCache;
-        } & typeof window;
-        g.__wasmModules = g.__wasmModules || {};
-        const cache: WasmCache = g.__wasmModules;
-        if (cache[moduleName]) {
-          wasmRef.current = cache[moduleName];
-          setIsLoaded(true);
-          return;
-        }
-
-        if (loadedRef.current) {
-          // Already loading/loaded in this component lifecycle
-          return;
-        }
-        loadedRef.current = true;
-
-        // Remove any existing script tag with the same src
-        const scriptSrc = `${import.meta.env.BASE_URL}wasm/${moduleName}.js`;
-        const existingScript = document.querySelector(
-          `script[src^="${scriptSrc}"]`
-        );
-        if (existingScript) {
-          existingScript.remove();
-        }
-
-        // Create and load new script
-        const script = document.createElement("script");
-        script.src = `${scriptSrc}?v=${new Date().getTime()}`;
-        script.async = true;
-
-        script.onload = async () => {
-          try {
-            // Wait a bit for the Module factory to be available
-            await new Promise((resolve) => setTimeout(resolve, 100));
-
-            const moduleLoader = (
-              window as unknown as { Module?: (args?: any) => Promise<WasmModule> }
-            ).Module;
-            if (moduleLoader) {
-              // If someone else already instantiated while we were loading, reuse it
-              if (cache[moduleName]) {
-                wasmRef.current = cache[moduleName];
-                setIsLoaded(true);
-                return;
-              }
-
-              const mod = await moduleLoader({
-                locateFile: (path: string) => {
-                  if (path.endsWith('.wasm')) {
-                    return `${import.meta.env.BASE_URL}wasm/${path}`;
-                  }
-                  return path;
-                }
-              });
-              console.log(
-                `[WASM LOADER] Loaded module for ${moduleName}:`,
-                mod
-              );
-              wasmRef.current = mod;
-              // Cache for reuse across mounts/renders
-              cache[moduleName] = mod;
-              if (mod) {
-                console.log(
-                  `[WASM LOADER] Exported keys for ${moduleName}:`,
-                  Object.keys(mod)
-                );
-              }
-              setIsLoaded(true);
-            } else {
-              console.error(`[WASM LOADER] Module not found for ${moduleName}`);
-              setError(`Module not found for ${moduleName}`);
-            }
-          } catch (err: unknown) {
-            const message = err instanceof Error ? err.message : String(err);
-            console.error(
-              `[WASM LOADER] Failed to initialize ${moduleName}:`,
-              message
-            );
-            setError(`Failed to initialize ${moduleName}: ${message}`);
-          }
-        };
-
-        script.onerror = () => {
-          console.error(`[WASM LOADER] Failed to load ${moduleName}.js`);
-          setError(`Failed to load ${moduleName}.js`);
-        };
-
-        document.body.appendChild(script);
-      } catch (err: unknown) {
+    // Instances are shared, so a remount (or StrictMode's double effect) reuses the first load
+    let active = true;
+    loadWasm(gameName).then(
+      (mod) => {
+        if (!active) return;
+        wasmRef.current = mod;
+        setIsLoaded(true);
+      },
+      (err: unknown) => {
+        if (!active) return;
         const message = err instanceof Error ? err.message : String(err);
-        console.error(`[WASM LOADER] Error loading WASM module:`, message);
-        setError(`Error loading WASM module: ${message}`);
+        console.error(`[WASM LOADER] Failed to load ${moduleName}:`, message);
+        setError(`Failed to load ${moduleName}: ${message}`);
       }
-    };
-
-    loadWasm();
-
+    );
     return () => {
-      // Do not delete the cached module. Only remove the script tag.
-      const scriptSrc = `${import.meta.env.BASE_URL}wasm/${moduleName}.js`;
-      const scriptToRemove = document.querySelector(
-        `script[src^="${scriptSrc}"]`
-      );
-      if (scriptToRemove) {
-        scriptToRemove.remove();
-      }
+      active = false;
     };
-  }, [moduleName]);
+  }, [gameName, moduleName]);
 
   return { wasmRef, isLoaded, error };
 }
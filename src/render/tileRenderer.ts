@@ -0,0 +1,304 @@
+// Draws a grid game's board from the engine's packed tile-id buffer (one byte
+// per cell, see cpp/Tiles.h) onto a single canvas. With WebGL the buffer is
+// uploaded as a texture and the whole board is one draw call: a fragment
+// shader looks each pixel's tile up in a small palette texture. Without
+// WebGL it falls back to Canvas 2D. Either way the board costs no React nodes.
+
+import { TILE } from "./tiles";
+
+const PALETTE_SIZE = 16; // room for every id in TILE
+
+export interface TileStyle {
+  color: string; // "#rrggbb": the whole tile, or its dot when dot is set
+  dot?: number; // draw a centred dot this wide (fraction of a cell) on background
+  background?: string;
+}
+
+export interface BoardStyle {
+  palette: Partial<Record<number, TileStyle>>; // by tile id; unlisted ids draw as EMPTY
+  background: string; // shows in the gaps between tiles
+  gap: number; // CSS px between tiles
+  radius: number; // CSS px corner radius of each tile
+}
+
+export interface TileRenderer {
+  // Copies the tiles (the caller may reuse its buffer) and redraws
+  update(tiles: Uint8Array, cols: number, rows: number): void;
+  readonly tiles: Uint8Array;
+  readonly cols: number;
+  readonly rows: number;
+  // Stops following the canvas; the last tiles stay readable
+  dispose(): void;
+}
+
+function rgb(hex: string): [number, number, number] {
+  const v = parseInt(hex.slice(1), 16);
+  return [(v >> 16) & 255, (v >> 8) & 255, v & 255];
+}
+
+function styleOf(board: BoardStyle, id: number): TileStyle {
+  return board.palette[id] ?? board.palette[TILE.EMPTY] ?? { color: board.background };
+}
+
+const VERTEX_SHADER = `
+attribute vec2 aPos;
+varying vec2 vUv;
+void main() {
+  vUv = vec2(aPos.x * 0.5 + 0.5, 0.5 - aPos.y * 0.5);
+  gl_Position = vec4(aPos, 0.0, 1.0);
+}`;
+
+// Palette row 0 is the tile color with alpha 1 for a full tile or the dot
+// width; row 1 is the color around a dot.
+const FRAGMENT_SHADER = `
+precision mediump float;
+uniform sampler2D uTiles;
+uniform sampler2D uPalette;
+uniform vec2 uGrid;
+uniform vec2 uCellPx;
+uniform float uGapPx;
+uniform float uRadiusPx;
+uniform vec3 uBoard;
+varying vec2 vUv;
+void main() {
+  vec2 pos = vUv * uGrid;
+  vec2 cell = min(floor(pos), uGrid - 1.0);
+  float id = floor(texture2D(uTiles, (cell + 0.5) / uGrid).r * 255.0 + 0.5);
+  float u = (id + 0.5) / ${PALETTE_SIZE}.0;
+  vec4 fg = texture2D(uPalette, vec2(u, 0.25));
+  vec3 bg = texture2D(uPalette, vec2(u, 0.75)).rgb;
+  vec2 p = (pos - cell - 0.5) * uCellPx;
+  vec2 q = abs(p) - (0.5 * uCellPx - 0.5 * uGapPx) + uRadiusPx;
+  float outside = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - uRadiusPx;
+  bool inDot = fg.a > 0.99 || length(p) <= fg.a * 0.5 * min(uCellPx.x, uCellPx.y);
+  gl_FragColor = vec4(outside > 0.0 ? uBoard : (inDot ? fg.rgb : bg), 1.0);
+}`;
+
+abstract class BaseRenderer implements TileRenderer {
+  tiles = new Uint8Array(0);
+  cols = 0;
+  rows = 0;
+  protected readonly canvas: HTMLCanvasElement;
+  protected readonly board: BoardStyle;
+  private readonly resizeObserver: ResizeObserver;
+
+  constructor(canvas: HTMLCanvasElement, board: BoardStyle) {
+    this.canvas = canvas;
+    this.board = board;
+    this.resizeObserver = new ResizeObserver(() => this.draw());
+    this.resizeObserver.observe(canvas);
+  }
+
+  update(tiles: Uint8Array, cols: number, rows: number) {
+    const n = cols * rows;
+    if (cols !== this.cols || rows !== this.rows) {
+      this.cols = cols;
+      this.rows = rows;
+      this.canvas.style.aspectRatio = `${cols} / ${rows}`;
+    }
+    if (this.tiles.length !== n) this.tiles = new Uint8Array(n);
+    this.tiles.set(tiles.subarray(0, n));
+    this.upload();
+    this.draw();
+  }
+
+  dispose() {
+    this.resizeObserver.disconnect();
+  }
+
+  // Matches the backing store to the canvas's CSS size; returns the device pixel ratio
+  protected fit() {
+    const dpr = window.devicePixelRatio || 1;
+    const w = Math.max(1, Math.round(this.canvas.clientWidth * dpr));
+    const h = Math.max(1, Math.round(this.canvas.clientHeight * dpr));
+    if (this.canvas.width !== w || this.canvas.height !== h) {
+      this.canvas.width = w;
+      this.canvas.height = h;
+    }
+    return dpr;
+  }
+
+  protected abstract upload(): void;
+  protected abstract draw(): void;
+}
+
+class WebGLTileRenderer extends BaseRenderer {
+  private readonly gl: WebGLRenderingContext;
+  private program: WebGLProgram | null = null;
+  private tileTexture: WebGLTexture | null = null;
+  private uploadedCols = 0;
+  private uploadedRows = 0;
+  private uniforms: Record<string, WebGLUniformLocation | null> = {};
+  private readonly onLost = (e: Event) => {
+    e.preventDefault();
+    this.program = null;
+  };
+  private readonly onRestored = () => {
+    this.setup();
+    this.upload();
+    this.draw();
+  };
+
+  constructor(canvas: HTMLCanvasElement, board: BoardStyle, gl: WebGLRenderingContext) {
+    super(canvas, board);
+    this.gl = gl;
+    canvas.addEventListener("webglcontextlost", this.onLost);
+    canvas.addEventListener("webglcontextrestored", this.onRestored);
+    this.setup();
+  }
+
+  private compile(type: number, source: string) {
+    const gl = this.gl;
+    const shader = gl.createShader(type)!;
+    gl.shaderSource(shader, source);
+    gl.compileShader(shader);
+    if (!gl.getShaderParameter(shader, gl.COMPILE_STATUS)) {
+      throw new Error(`tile shader: ${gl.getShaderInfoLog(shader)}`);
+    }
+    return shader;
+  }
+
+  private texture(unit: number) {
+    const gl = this.gl;
+    const tex = gl.createTexture();
+    gl.activeTexture(gl.TEXTURE0 + unit);
+    gl.bindTexture(gl.TEXTURE_2D, tex);
+    gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.NEAREST);
+    gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MAG_FILTER, gl.NEAREST);
+    gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_S, gl.CLAMP_TO_EDGE);
+    gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_T, gl.CLAMP_TO_EDGE);
+    return tex;
+  }
+
+  // Program, full-screen quad and palette; everything a lost context drops
+  private setup() {
+    const gl = this.gl;
+    const program = gl.createProgram()!;
+    gl.attachShader(program, this.compile(gl.VERTEX_SHADER, VERTEX_SHADER));
+    gl.attachShader(program, this.compile(gl.FRAGMENT_SHADER, FRAGMENT_SHADER));
+    gl.linkProgram(program);
+    if (!gl.getProgramParameter(program, gl.LINK_STATUS)) {
+      throw new Error(`tile shader: ${gl.getProgramInfoLog(program)}`);
+    }
+    gl.useProgram(program);
+    for (const name of ["uTiles", "uPalette", "uGrid", "uCellPx", "uGapPx", "uRadiusPx", "uBoard"]) {
+      this.uniforms[name] = gl.getUniformLocation(program, name);
+    }
+
+    gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer());
+    gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([-1, -1, 1, -1, -1, 1, 1, 1]), gl.STATIC_DRAW);
+    const aPos = gl.getAttribLocation(program, "aPos");
+    gl.enableVertexAttribArray(aPos);
+    gl.vertexAttribPointer(aPos, 2, gl.FLOAT, false, 0, 0);
+
+    const palette = new Uint8Array(PALETTE_SIZE * 2 * 4);
+    for (let id = 0; id < PALETTE_SIZE; id++) {
+      const style = styleOf(this.board, id);
+      const dot = style.dot === undefined ? 255 : Math.min(254, Math.round(style.dot * 255));
+      palette.set([...rgb(style.color), dot], id * 4);
+      palette.set([...rgb(style.background ?? style.color), 255], (PALETTE_SIZE + id) * 4);
+    }
+    this.texture(1);
+    gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, PALETTE_SIZE, 2, 0, gl.RGBA, gl.UNSIGNED_BYTE, palette);
+    this.tileTexture = this.texture(0);
+    this.uploadedCols = 0;
+    this.uploadedRows = 0;
+
+    gl.uniform1i(this.uniforms.uTiles, 0);
+    gl.uniform1i(this.uniforms.uPalette, 1);
+    gl.uniform3fv(this.uniforms.uBoard, rgb(this.board.background).map((c) => c / 255));
+    this.program = program;
+  }
+
+  protected upload() {
+    const gl = this.gl;
+    if (!this.program || !this.cols) return;
+    gl.activeTexture(gl.TEXTURE0);
+    gl.bindTexture(gl.TEXTURE_2D, this.tileTexture);
+    gl.pixelStorei(gl.UNPACK_ALIGNMENT, 1);
+    if (this.cols !== this.uploadedCols || this.rows !== this.uploadedRows) {
+      gl.texImage2D(gl.TEXTURE_2D, 0, gl.LUMINANCE, this.cols, this.rows, 0, gl.LUMINANCE, gl.UNSIGNED_BYTE, this.tiles);
+      this.uploadedCols = this.cols;
+      this.uploadedRows = this.rows;
+    } else {
+      gl.texSubImage2D(gl.TEXTURE_2D, 0, 0, 0, this.cols, this.rows, gl.LUMINANCE, gl.UNSIGNED_BYTE, this.tiles);
+    }
+  }
+
+  protected draw() {
+    const gl = this.gl;
+    if (!this.program || !this.cols) return;
+    const dpr = this.fit();
+    const { width, height } = this.canvas;
+    gl.viewport(0, 0, width, height);
+    gl.uniform2f(this.uniforms.uGrid, this.cols, this.rows);
+    gl.uniform2f(this.uniforms.uCellPx, width / this.cols, height / this.rows);
+    gl.uniform1f(this.uniforms.uGapPx, this.board.gap * dpr);
+    gl.uniform1f(this.uniforms.uRadiusPx, this.board.radius * dpr);
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4);
+  }
+
+  dispose() {
+    super.dispose();
+    this.canvas.removeEventListener("webglcontextlost", this.onLost);
+    this.canvas.removeEventListener("webglcontextrestored", this.onRestored);
+  }
+}
+
+class CanvasTileRenderer extends BaseRenderer {
+  private readonly ctx: CanvasRenderingContext2D;
+
+  constructor(canvas: HTMLCanvasElement, board: BoardStyle, ctx: CanvasRenderingContext2D) {
+    super(canvas, board);
+    this.ctx = ctx;
+  }
+
+  protected upload() {}
+
+  protected draw() {
+    if (!this.cols) return;
+    const dpr = this.fit();
+    const ctx = this.ctx;
+    const { width, height } = this.canvas;
+    const cellW = width / this.cols;
+    const cellH = height / this.rows;
+    const gap = this.board.gap * dpr;
+    const tileW = cellW - gap;
+    const tileH = cellH - gap;
+    const r = Math.max(0, Math.min(this.board.radius * dpr, tileW / 2, tileH / 2));
+    ctx.fillStyle = this.board.background;
+    ctx.fillRect(0, 0, width, height);
+    for (let i = 0; i < this.tiles.length; i++) {
+      const style = styleOf(this.board, this.tiles[i]);
+      const x = (i % this.cols) * cellW;
+      const y = Math.floor(i / this.cols) * cellH;
+      ctx.fillStyle = style.dot === undefined ? style.color : style.background ?? style.color;
+      // Same rounded tile as the shader; arcTo rather than roundRect, which
+      // browsers without WebGL are the likeliest to lack
+      const left = x + gap / 2;
+      const top = y + gap / 2;
+      ctx.beginPath();
+      ctx.moveTo(left + r, top);
+      ctx.arcTo(left + tileW, top, left + tileW, top + tileH, r);
+      ctx.arcTo(left + tileW, top + tileH, left, top + tileH, r);
+      ctx.arcTo(left, top + tileH, left, top, r);
+      ctx.arcTo(left, top, left + tileW, top, r);
+      ctx.closePath();
+      ctx.fill();
+      if (style.dot !== undefined) {
+        ctx.fillStyle = style.color;
+        ctx.beginPath();
+        ctx.arc(x + cellW / 2, y + cellH / 2, (style.dot * Math.min(cellW, cellH)) / 2, 0, Math.PI * 2);
+        ctx.fill();
+      }
+    }
+  }
+}
+
+export function createTileRenderer(canvas: HTMLCanvasElement, board: BoardStyle): TileRenderer {
+  const gl = canvas.getContext("webgl", { antialias: false, alpha: false });
+  if (gl) return new WebGLTileRenderer(canvas, board, gl);
+  const ctx = canvas.getContext("2d");
+  if (!ctx) throw new Error("canvas has neither a WebGL nor a 2D context");
+  return new CanvasTileRenderer(canvas, board, ctx);
+}
@@ -0,0 +1,11 @@
+// Tile ids of the engines' packed tile buffers, matching cpp/Tiles.h
+export const TILE = {
+  EMPTY: 0,
+  WALL: 1,
+  PELLET: 2,
+  POWER_PELLET: 3,
+  PACMAN: 4,
+  GHOST: 5,
+  SNAKE: 6,
+  FOOD: 7,
+} as const;
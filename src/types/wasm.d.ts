@@ -8,13 +8,19 @@ interface WasmModule {
   _malloc?: (size: number) => number;
   _free?: (ptr: number) => void;
   HEAPU8?: Uint8Array;
+  HEAP32?: Int32Array;
   // Guess The Number functions
-  _start_game?: (maxNumber: number) => void;
-  _set_hint_difficulty?: (level: number) => void;
-  _make_guess?: (guess: number) => number;
-  _make_guess_hint?: (guess: number) => number;
-  _get_attempts?: () => number;
+  _guess_set_seed?: (seed: bigint) => void;
+  _guess_start_game?: (maxNumber: number) => void;
+  _guess_set_hint_difficulty?: (level: number) => void;
+  _guess_make_guess?: (guess: number) => number;
+  _guess_make_guess_hint?: (guess: number) => number;
+  _guess_get_attempts?: () => number;
   // Tic Tac Toe functions
+  _ttt_create?: () => number;
+  _ttt_destroy?: (id: number) => number;
+  _ttt_use?: (id: number) => number;
+  _ttt_set_seed?: (seed: bigint) => void;
   _ttt_start_game?: () => void;
   _ttt_get_current_player?: () => number;
   _ttt_make_move?: (index: number) => number;
@@ -22,41 +28,103 @@ interface WasmModule {
   _ttt_get_board?: (ptr: number) => void;
   _ttt_check_winner?: () => number;
   _ttt_ai_move?: (difficulty: number) => number;
+  _ttt_configure?: (m: number, n: number, k: number) => number;
+  _ttt_get_width?: () => number;
+  _ttt_get_height?: () => number;
+  _ttt_get_win_length?: () => number;
+  _ttt_set_time_budget_ms?: (ms: number) => void;
   _ttt_reset?: () => void;
+  _ttt_snapshot_size?: () => number;
+  _ttt_snapshot?: (ptr: number) => number;
+  _ttt_restore?: (ptr: number, length: number) => number;
 
   // Snake functions
+  _snake_create?: () => number;
+  _snake_destroy?: (id: number) => number;
+  _snake_use?: (id: number) => number;
+  _snake_set_seed?: (seed: bigint) => void;
   _snake_start_game?: () => void;
   _snake_set_direction?: (direction: number) => void;
+  _snake_configure?: (width: number, height: number) => number;
   _snake_set_difficulty?: (level: number) => void;
   _snake_tick?: () => number;
   _snake_update?: () => number;
+  _snake_step_n?: (steps: number) => number;
   _snake_get_width?: () => number;
   _snake_get_height?: () => number;
   _snake_get_move_interval_ms?: () => number;
   _snake_get_cell?: (index: number) => number;
+  _snake_get_dirty_count?: () => number;
+  _snake_get_dirty_ptr?: () => number;
+  _snake_clear_dirty?: () => void;
   _snake_get_score?: () => number;
   _snake_is_game_over?: () => number;
+  _snake_replay_get_ptr?: () => number;
+  _snake_replay_get_size?: () => number;
+  _snake_replay_load?: (ptr: number, length: number) => number;
+  _snake_replay_seek?: (tick: number) => number;
+  _snake_snapshot_size?: () => number;
+  _snake_snapshot?: (ptr: number) => number;
+  _snake_restore?: (ptr: number, length: number) => number;
   // Pacman functions
+  _pacman_create?: () => number;
+  _pacman_destroy?: (id: number) => number;
+  _pacman_use?: (id: number) => number;
+  _pacman_set_seed?: (seed: bigint) => void;
   _pacman_start_game?: () => void;
   _pacman_set_direction?: (direction: number) => void;
+  _pacman_set_ghost_count?: (count: number) => number;
   _pacman_tick?: () => number;
   _pacman_update?: () => number;
   _pacman_get_width?: () => number;
   _pacman_get_height?: () => number;
   _pacman_get_cell?: (index: number) => number;
+  _pacman_get_dirty_count?: () => number;
+  _pacman_get_dirty_ptr?: () => number;
+  _pacman_clear_dirty?: () => void;
+  _pacman_debug_get_alloc_count?: () => number;
+  _pacman_get_frame_ptr?: () => number;
+  _pacman_render_frame?: () => number;
   _pacman_get_score?: () => number;
+  _pacman_get_pellets_remaining?: () => number;
   _pacman_is_game_over?: () => number;
+  _pacman_replay_get_ptr?: () => number;
+  _pacman_replay_get_size?: () => number;
+  _pacman_replay_load?: (ptr: number, length: number) => number;
+  _pacman_replay_seek?: (tick: number) => number;
+  _pacman_snapshot_size?: () => number;
+  _pacman_snapshot?: (ptr: number) => number;
+  _pacman_restore?: (ptr: number, length: number) => number;
 
   // Flappy Bird functions
+  _flappy_create?: () => number;
+  _flappy_destroy?: (id: number) => number;
+  _flappy_use?: (id: number) => number;
+  _flappy_set_seed?: (seed: bigint) => void;
   _flappy_start_game?: () => void;
   _flappy_flap?: () => void;
   _flappy_tick?: () => number;
   _flappy_update?: () => number;
+  _flappy_advance?: (elapsedMs: number) => number;
+  _flappy_get_render_bird_y?: (alpha: number) => number;
+  _flappy_get_render_scroll?: (alpha: number) => number;
+  _flappy_get_entities_ptr?: () => number;
+  _flappy_get_fp_one?: () => number;
   _flappy_has_started?: () => number;
   _flappy_get_bird_y?: () => number;
   _flappy_get_width?: () => number;
   _flappy_get_height?: () => number;
   _flappy_get_cell?: (index: number) => number;
+  _flappy_get_dirty_count?: () => number;
+  _flappy_get_dirty_ptr?: () => number;
+  _flappy_clear_dirty?: () => void;
   _flappy_get_score?: () => number;
   _flappy_is_game_over?: () => number;
+  _flappy_replay_get_ptr?: () => number;
+  _flappy_replay_get_size?: () => number;
+  _flappy_replay_load?: (ptr: number, length: number) => number;
+  _flappy_replay_seek?: (tick: number) => number;
+  _flappy_snapshot_size?: () => number;
+  _flappy_snapshot?: (ptr: number) => number;
+  _flappy_restore?: (ptr: number, length: number) => number;
 }
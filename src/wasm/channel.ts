@@ -0,0 +1,224 @@
+// Shared-memory plumbing between the engine worker and the page.
+//
+// FrameChannel: the worker publishes each finished frame, the page reads the
+// newest one whenever it draws. There are two slots; the worker always fills
+// the one not holding the newest frame, then flips FRONT and bumps SEQ. The
+// next publish can start rewriting a slot as soon as SEQ moves, so a reader
+// keeps its copy only if SEQ did not change while it copied, and retries
+// otherwise.
+//
+// InputRing: the page pushes timestamped input events, the worker drains them
+// at tick boundaries. Single producer, single consumer, power-of-two capacity;
+// each side only ever writes its own index.
+//
+// Both live in a SharedArrayBuffer when the page is cross-origin isolated.
+// Otherwise the same layouts sit in plain ArrayBuffers and the worker posts
+// frame copies / the page posts events instead (see useEngineWorker).
+
+export const sharedMemory =
+  typeof SharedArrayBuffer !== "undefined" && globalThis.crossOriginIsolated === true;
+
+function allocate(bytes: number): ArrayBuffer | SharedArrayBuffer {
+  return sharedMemory ? new SharedArrayBuffer(bytes) : new ArrayBuffer(bytes);
+}
+
+// Wall-clock milliseconds, comparable between the page and the worker (their
+// performance.now() origins differ)
+export const now = () => performance.timeOrigin + performance.now();
+
+// Frame header words; game-specific status follows (see protocol.ts)
+export const STATUS_WORDS = 14;
+
+const SEQ = 0;
+const FRONT = 1;
+const CHANNEL_HEADER_BYTES = 8;
+// Slot: Float64 publish time, Int32 seq, Int32 payload length, Int32 status[STATUS_WORDS], payload
+const SLOT_HEADER_BYTES = 8 + 8 + STATUS_WORDS * 4;
+
+export interface Frame {
+  seq: number;
+  time: number;
+  status: Int32Array;
+  payload: Uint8Array; // valid up to payloadLength
+  payloadLength: number;
+}
+
+interface Slot {
+  time: Float64Array;
+  meta: Int32Array; // seq, payload length
+  status: Int32Array;
+  payload: Uint8Array;
+}
+
+class FrameLayout {
+  readonly header: Int32Array;
+  readonly slots: Slot[];
+  readonly buffer: ArrayBuffer | SharedArrayBuffer;
+
+  constructor(buffer: ArrayBuffer | SharedArrayBuffer) {
+    this.buffer = buffer;
+    this.header = new Int32Array(buffer, 0, 2);
+    const slotBytes = (buffer.byteLength - CHANNEL_HEADER_BYTES) / 2;
+    this.slots = [0, 1].map((i) => {
+      const base = CHANNEL_HEADER_BYTES + i * slotBytes;
+      return {
+        time: new Float64Array(buffer, base, 1),
+        meta: new Int32Array(buffer, base + 8, 2),
+        status: new Int32Array(buffer, base + 16, STATUS_WORDS),
+        payload: new Uint8Array(buffer, base + SLOT_HEADER_BYTES, slotBytes - SLOT_HEADER_BYTES),
+      };
+    });
+  }
+}
+
+export function createFrameBuffer(payloadBytes: number) {
+  const slotBytes = SLOT_HEADER_BYTES + Math.ceil(payloadBytes / 8) * 8;
+  return allocate(CHANNEL_HEADER_BYTES + 2 * slotBytes);
+}
+
+export class FrameWriter {
+  private readonly layout: FrameLayout;
+
+  constructor(buffer: ArrayBuffer | SharedArrayBuffer) {
+    this.layout = new FrameLayout(buffer);
+  }
+
+  get buffer() {
+    return this.layout.buffer;
+  }
+
+  // fill() writes status words and payload bytes and returns the payload length
+  publish(time: number, fill: (status: Int32Array, payload: Uint8Array) => number) {
+    const h = this.layout.header;
+    const back = 1 - Atomics.load(h, FRONT);
+    const seq = (Atomics.load(h, SEQ) + 1) | 0;
+    const slot = this.layout.slots[back];
+    slot.time[0] = time;
+    slot.meta[0] = seq;
+    slot.meta[1] = fill(slot.status, slot.payload);
+    Atomics.store(h, FRONT, back);
+    Atomics.store(h, SEQ, seq);
+  }
+}
+
+const emptyFrame = (): Frame => ({
+  seq: 0,
+  time: 0,
+  status: new Int32Array(STATUS_WORDS),
+  payload: new Uint8Array(0),
+  payloadLength: 0,
+});
+
+export class FrameReader {
+  private layout: FrameLayout;
+  private current: Frame | null = null;
+  private scratch = emptyFrame();
+
+  constructor(buffer: ArrayBuffer | SharedArrayBuffer) {
+    this.layout = new FrameLayout(buffer);
+  }
+
+  // Without shared memory the worker posts a copy of the channel per frame
+  replace(buffer: ArrayBuffer) {
+    this.layout = new FrameLayout(buffer);
+  }
+
+  // The newest published frame (copied, so it stays intact while the worker
+  // carries on), or null before the first. Compare seq to spot new frames.
+  read(): Frame | null {
+    const h = this.layout.header;
+    for (let tries = 0; tries < 4; tries++) {
+      const seq = Atomics.load(h, SEQ);
+      if (seq === 0 || (this.current && this.current.seq === seq)) return this.current;
+      const slot = this.layout.slots[Atomics.load(h, FRONT)];
+      const frame = this.scratch;
+      if (frame.payload.length < slot.payload.length) frame.payload = new Uint8Array(slot.payload.length);
+      const length = Math.min(Math.max(slot.meta[1], 0), slot.payload.length);
+      frame.time = slot.time[0];
+      frame.seq = slot.meta[0];
+      frame.status.set(slot.status);
+      frame.payload.set(slot.payload.subarray(0, length));
+      frame.payloadLength = length;
+      // publish() writes the back slot before it bumps SEQ, so once SEQ has
+      // moved the next publish may already be rewriting the slot just copied
+      if (Atomics.load(h, SEQ) === seq) {
+        this.scratch = this.current ?? emptyFrame();
+        this.current = frame;
+        return frame;
+      }
+    }
+    return this.current;
+  }
+}
+
+const HEAD = 0; // next slot the producer writes
+const TAIL = 1; // next slot the consumer reads
+
+export function createInputBuffer(capacity: number) {
+  if (capacity & (capacity - 1)) throw new Error("input ring capacity must be a power of two");
+  // Int32 head, tail; Int32 (code, value) per event; Float64 time per event
+  return allocate(8 + capacity * 8 + capacity * 8);
+}
+
+class InputLayout {
+  readonly indices: Int32Array;
+  readonly events: Int32Array;
+  readonly times: Float64Array;
+  readonly mask: number;
+
+  constructor(buffer: ArrayBuffer | SharedArrayBuffer) {
+    const capacity = (buffer.byteLength - 8) / 16;
+    this.mask = capacity - 1;
+    this.indices = new Int32Array(buffer, 0, 2);
+    this.events = new Int32Array(buffer, 8, capacity * 2);
+    this.times = new Float64Array(buffer, 8 + capacity * 8, capacity);
+  }
+}
+
+export class InputWriter {
+  private readonly ring: InputLayout;
+
+  constructor(buffer: ArrayBuffer | SharedArrayBuffer) {
+    this.ring = new InputLayout(buffer);
+  }
+
+  // False (event dropped) when the consumer has fallen a full ring behind
+  push(code: number, value: number, time: number) {
+    const r = this.ring;
+    const head = Atomics.load(r.indices, HEAD);
+    if (((head - Atomics.load(r.indices, TAIL)) | 0) > r.mask) return false;
+    const i = head & r.mask;
+    r.events[2 * i] = code;
+    r.events[2 * i + 1] = value;
+    r.times[i] = time;
+    Atomics.store(r.indices, HEAD, (head + 1) | 0);
+    return true;
+  }
+}
+
+export class InputReader {
+  private readonly ring: InputLayout;
+
+  constructor(buffer: ArrayBuffer | SharedArrayBuffer) {
+    this.ring = new InputLayout(buffer);
+  }
+
+  // Hands every event stamped at or before `until` to apply, oldest first
+  drain(until: number, apply: (code: number, value: number, time: number) => void) {
+    const r = this.ring;
+    const head = Atomics.load(r.indices, HEAD);
+    let tail = Atomics.load(r.indices, TAIL);
+    while (tail !== head) {
+      const i = tail & r.mask;
+      if (r.times[i] > until) break;
+      apply(r.events[2 * i], r.events[2 * i + 1], r.times[i]);
+      tail = (tail + 1) | 0;
+    }
+    Atomics.store(r.indices, TAIL, tail);
+  }
+
+  // Drops everything queued, e.g. inputs aimed at a game that was restarted
+  clear() {
+    Atomics.store(this.ring.indices, TAIL, Atomics.load(this.ring.indices, HEAD));
+  }
+}
@@ -0,0 +1,218 @@
+import type { WasmModule } from "../types/wasm";
+import {
+  FrameWriter,
+  InputReader,
+  InputWriter,
+  createFrameBuffer,
+  createInputBuffer,
+  now,
+  sharedMemory,
+} from "./channel";
+import { EngineInputRing } from "./engineInput";
+import { instantiateWasmFor } from "./loader";
+import {
+  FLAPPY_STATUS,
+  INPUT_CAPACITY,
+  PACMAN_STATUS,
+  STATUS,
+  type EngineGame,
+  type FromWorker,
+  type ToWorker,
+} from "./protocol";
+
+// Hosts one real-time game's engine off the main thread. The engine steps at
+// its own fixed rate and publishes every finished step to the frame channel,
+// so React renders never delay the simulation. Before each step, the inputs
+// stamped up to its scheduled time move from the page's ring into the
+// engine's own ring in WASM memory, where the engine applies them with its
+// game's rules.
+
+// Stalls longer than this (a suspended tab) are dropped rather than caught up
+const MAX_CATCH_UP_MS = 1000;
+
+interface EngineAdapter {
+  start(mod: WasmModule): void;
+  stepMs(mod: WasmModule): number;
+  step(mod: WasmModule): void;
+  over(mod: WasmModule): boolean;
+  inputPtr(mod: WasmModule): number;
+  payloadBytes(mod: WasmModule): number;
+  // Status words and payload of the current state; returns the payload length
+  fill(mod: WasmModule, status: Int32Array, payload: Uint8Array): number;
+}
+
+function copyFromHeap(mod: WasmModule, ptr: number, length: number, payload: Uint8Array) {
+  if (!ptr || !mod.HEAPU8) return 0;
+  const n = Math.min(length, payload.length);
+  payload.set(mod.HEAPU8.subarray(ptr, ptr + n));
+  return n;
+}
+
+// Payload of the grid games: the engine's tile-id buffer (cpp/Tiles.h)
+const ADAPTERS: Record<EngineGame, EngineAdapter> = {
+  Snake: {
+    start(mod) {
+      mod._snake_set_difficulty?.(2);
+      mod._snake_start_game?.();
+    },
+    stepMs: (mod) => mod._snake_get_move_interval_ms?.() ?? 150,
+    step: (mod) => mod._snake_step_n?.(1),
+    over: (mod) => !!mod._snake_is_game_over?.(),
+    inputPtr: (mod) => mod._snake_input_ptr?.() ?? 0,
+    payloadBytes: (mod) => (mod._snake_get_width?.() ?? 20) * (mod._snake_get_height?.() ?? 20),
+    fill(mod, status, payload) {
+      const w = mod._snake_get_width?.() ?? 20;
+      const h = mod._snake_get_height?.() ?? 20;
+      status[STATUS.SCORE] = mod._snake_get_score?.() ?? 0;
+      status[STATUS.GAME_OVER] = mod._snake_is_game_over?.() ?? 0;
+      status[STATUS.WIDTH] = w;
+      status[STATUS.HEIGHT] = h;
+      status[STATUS.STEP_MS] = this.stepMs(mod);
+      return copyFromHeap(mod, mod._snake_get_tiles_ptr?.() ?? 0, w * h, payload);
+    },
+  },
+
+  Pacman: {
+    start: (mod) => mod._pacman_start_game?.(2), // default level; the UI has no difficulty controls
+    stepMs: () => 90,
+    step: (mod) => mod._pacman_update?.(),
+    over: (mod) => !!mod._pacman_is_game_over?.(),
+    inputPtr: (mod) => mod._pacman_input_ptr?.() ?? 0,
+    payloadBytes: (mod) => (mod._pacman_get_width?.() ?? 28) * (mod._pacman_get_height?.() ?? 31),
+    fill(mod, status, payload) {
+      const w = mod._pacman_get_width?.() ?? 28;
+      const h = mod._pacman_get_height?.() ?? 31;
+      status[STATUS.SCORE] = mod._pacman_get_score?.() ?? 0;
+      status[STATUS.GAME_OVER] = mod._pacman_is_game_over?.() ?? 0;
+      status[STATUS.WIDTH] = w;
+      status[STATUS.HEIGHT] = h;
+      status[STATUS.STEP_MS] = 90;
+      status[PACMAN_STATUS.PELLETS] = mod._pacman_get_pellets_remaining?.() ?? 0;
+      // Ticks keep the tile buffer current, so no full re-render is needed
+      return copyFromHeap(mod, mod._pacman_get_tiles_ptr?.() ?? 0, w * h, payload);
+    },
+  },
+
+  // Payload: the entity export, int32 [birdY, count, (x, gapY, gapHeight)...]
+  FlappyBird: {
+    start: (mod) => mod._flappy_start_game?.(),
+    stepMs: () => 20, // FB_STEP_MS
+    step: (mod) => mod._flappy_tick?.(),
+    over: (mod) => !!mod._flappy_is_game_over?.(),
+    inputPtr: (mod) => mod._flappy_input_ptr?.() ?? 0,
+    payloadBytes: () => (2 + 64 * 3) * 4, // FB_ENTITY_HEADER + FB_PIPE_CAPACITY * FB_ENTITY_STRIDE
+    fill(mod, status, payload) {
+      const fpOne = mod._flappy_get_fp_one?.() ?? 65536;
+      status[STATUS.SCORE] = mod._flappy_get_score?.() ?? 0;
+      status[STATUS.GAME_OVER] = mod._flappy_is_game_over?.() ?? 0;
+      status[STATUS.WIDTH] = mod._flappy_get_width?.() ?? 28;
+      status[STATUS.HEIGHT] = mod._flappy_get_height?.() ?? 20;
+      status[STATUS.STEP_MS] = 20;
+      status[FLAPPY_STATUS.STARTED] = mod._flappy_has_started?.() ?? 0;
+      status[FLAPPY_STATUS.BIRD_Y_PREV] = Math.round((mod._flappy_get_render_bird_y?.(0) ?? 0) * fpOne);
+      status[FLAPPY_STATUS.BIRD_Y] = Math.round((mod._flappy_get_render_bird_y?.(1) ?? 0) * fpOne);
+      status[FLAPPY_STATUS.SCROLL] = Math.round((mod._flappy_get_render_scroll?.(0) ?? 0) * fpOne);
+      status[FLAPPY_STATUS.FP_ONE] = fpOne;
+      const ptr = mod._flappy_get_entities_ptr?.() ?? 0;
+      const count = ptr && mod.HEAP32 ? mod.HEAP32[(ptr >> 2) + 1] : 0;
+      return copyFromHeap(mod, ptr, (2 + count * 3) * 4, payload);
+    },
+  },
+};
+
+let mod: WasmModule | null = null;
+let adapter: EngineAdapter | null = null;
+let frames: FrameWriter | null = null;
+let inputs: InputReader | null = null;
+let engineInputs: EngineInputRing | null = null;
+// Without shared memory the page posts its inputs and this side queues them
+let postedInputs: InputWriter | null = null;
+let nextStepAt = 0;
+let timer: ReturnType<typeof setTimeout> | null = null;
+
+function send(message: FromWorker, transfer: Transferable[] = []) {
+  self.postMessage(message, { transfer });
+}
+
+function fail(err: unknown) {
+  if (timer !== null) clearTimeout(timer);
+  timer = null;
+  send({ type: "error", message: err instanceof Error ? err.message : String(err) });
+}
+
+function publish(time: number) {
+  if (!mod || !adapter || !frames) return;
+  const m = mod;
+  const a = adapter;
+  frames.publish(time, (status, payload) => a.fill(m, status, payload));
+  if (!sharedMemory) {
+    const copy = (frames.buffer as ArrayBuffer).slice(0);
+    send({ type: "frame", frames: copy }, [copy]);
+  }
+}
+
+function run() {
+  timer = null;
+  if (!mod || !adapter || !inputs || !engineInputs) return;
+  const m = mod;
+  const a = adapter;
+  const ring = engineInputs;
+  try {
+    const t = now();
+    if (t - nextStepAt > MAX_CATCH_UP_MS) nextStepAt = t;
+    let steppedAt = -1;
+    while (nextStepAt <= t && !a.over(m)) {
+      // Inputs stamped before this step was due belong to it; later ones wait.
+      // An engine that already holds a full ring of them drops the rest.
+      inputs.drain(nextStepAt, (code, value, time) => ring.push(code, value, time));
+      a.step(m);
+      steppedAt = nextStepAt;
+      nextStepAt += a.stepMs(m);
+    }
+    // Stamped with when the step was due, which the page interpolates from
+    if (steppedAt >= 0) publish(steppedAt);
+    if (a.over(m)) return;
+    timer = setTimeout(run, Math.max(0, nextStepAt - now()));
+  } catch (err) {
+    fail(err);
+  }
+}
+
+function start() {
+  if (!mod || !adapter || !inputs) return;
+  if (timer !== null) clearTimeout(timer);
+  // Inputs queued for the previous round must not leak into this one
+  inputs.clear();
+  adapter.start(mod);
+  const t = now();
+  publish(t);
+  nextStepAt = t + adapter.stepMs(mod);
+  timer = setTimeout(run, adapter.stepMs(mod));
+}
+
+async function init(game: EngineGame, wasmModule: WebAssembly.Module) {
+  const instance = (await instantiateWasmFor(game, wasmModule)) as WasmModule;
+  const a = ADAPTERS[game];
+  const inputPtr = a.inputPtr(instance);
+  if (!inputPtr) throw new Error(`${game} has no input ring; run bun run wasm:build`);
+  const frameBuffer = createFrameBuffer(a.payloadBytes(instance));
+  const inputBuffer = createInputBuffer(INPUT_CAPACITY);
+  mod = instance;
+  adapter = a;
+  frames = new FrameWriter(frameBuffer);
+  inputs = new InputReader(inputBuffer);
+  engineInputs = new EngineInputRing(instance, inputPtr);
+  if (!sharedMemory) postedInputs = new InputWriter(inputBuffer);
+  send({ type: "ready", frames: frameBuffer, inputs: inputBuffer, shared: sharedMemory });
+}
+
+self.onmessage = (e: MessageEvent<ToWorker>) => {
+  const msg = e.data;
+  try {
+    if (msg.type === "init") init(msg.game, msg.wasmModule).catch(fail);
+    else if (msg.type === "start") start();
+    else if (msg.type === "input") postedInputs?.push(msg.code, msg.value, msg.time);
+  } catch (err) {
+    fail(err);
+  }
+};
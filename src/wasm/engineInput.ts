@@ -0,0 +1,45 @@
+import type { WasmModule } from "../types/wasm";
+
+// JS producer for an engine's input ring (cpp/InputRing.h): events are written
+// straight into WASM memory, and the engine drains them at its next tick.
+// Must match InputRing's layout: uint32 head, tail, capacity, reserved, then
+// 16-byte events of float64 time, int32 code, int32 value.
+const EVENTS_OFFSET = 16;
+const EVENT_BYTES = 16;
+
+export class EngineInputRing {
+  private readonly mod: WasmModule;
+  private readonly ptr: number;
+  private memory: ArrayBuffer | null = null;
+  private u32 = new Uint32Array(0);
+  private i32 = new Int32Array(0);
+  private f64 = new Float64Array(0);
+
+  constructor(mod: WasmModule, ptr: number) {
+    this.mod = mod;
+    this.ptr = ptr;
+  }
+
+  // False (event dropped) when the engine has a full ring of inputs pending
+  push(code: number, value: number, time: number) {
+    const heap = this.mod.HEAPU8;
+    if (!heap) return false;
+    // Growing WASM memory replaces its buffer, which detaches old views
+    if (heap.buffer !== this.memory) {
+      this.memory = heap.buffer as ArrayBuffer;
+      this.u32 = new Uint32Array(this.memory);
+      this.i32 = new Int32Array(this.memory);
+      this.f64 = new Float64Array(this.memory);
+    }
+    const header = this.ptr >> 2;
+    const head = this.u32[header];
+    const capacity = this.u32[header + 2];
+    if (((head - this.u32[header + 1]) >>> 0) >= capacity) return false;
+    const e = this.ptr + EVENTS_OFFSET + (head & (capacity - 1)) * EVENT_BYTES;
+    this.f64[e >> 3] = time;
+    this.i32[(e + 8) >> 2] = code;
+    this.i32[(e + 12) >> 2] = value;
+    this.u32[header] = (head + 1) >>> 0;
+    return true;
+  }
+}
@@ -0,0 +1,135 @@
+import type { WasmModule } from "../hooks/useWasmLoader";
+
+// Loading of the Emscripten modules, shared by the useWasmLoader hook and the
+// engine worker (so it must not depend on React or the DOM).
+
+type ModuleFactory = (args?: Record<string, unknown>) => Promise<WasmModule>;
+
+// Content-hashed file names of one module, from public/wasm/manifest.json
+interface ManifestEntry {
+  js: string;
+  wasm: string;
+}
+
+// With VITE_WASM_CORE=1 every game loads the combined ArcadeCore module
+// (`bash make.sh core`), so switching games reuses one instance
+const USE_CORE = import.meta.env.VITE_WASM_CORE === "1";
+const WASM_BASE = `${import.meta.env.BASE_URL}wasm/`;
+
+export const moduleNameFor = (gameName: string) => (USE_CORE ? "ArcadeCore" : gameName);
+
+// Loads are shared by every caller and kept for the page's lifetime, keyed by
+// module name: glue factories, compiled WebAssembly.Modules (which
+// prefetchWasm fills early) and instances.
+let manifestPromise: Promise<Record<string, ManifestEntry>> | null = null;
+const factories = new Map<string, Promise<ModuleFactory>>();
+const compiled = new Map<string, Promise<WebAssembly.Module>>();
+const instances = new Map<string, Promise<WasmModule>>();
+
+// A failed load is forgotten so the next attempt retries it
+function memo<T>(cache: Map<string, Promise<T>>, key: string, load: () => Promise<T>) {
+  let p = cache.get(key);
+  if (!p) {
+    p = load();
+    cache.set(key, p);
+    p.catch(() => cache.delete(key));
+  }
+  return p;
+}
+
+// The hashed files never change under a name, so HTTP and the service worker
+// cache them as-is; only this small manifest is revalidated (the service
+// worker serves it network-first, falling back to its cache when offline).
+function loadManifest() {
+  if (!manifestPromise) {
+    const p = fetch(`${WASM_BASE}manifest.json`, { cache: "no-cache" }).then((res) => {
+      if (!res.ok) throw new Error(`manifest.json: HTTP ${res.status}`);
+      return res.json() as Promise<Record<string, ManifestEntry>>;
+    });
+    p.catch(() => (manifestPromise = null));
+    manifestPromise = p;
+  }
+  return manifestPromise;
+}
+
+async function manifestEntry(name: string) {
+  const entry = (await loadManifest())[name];
+  if (!entry) throw new Error(`${name} is not in manifest.json; run bun run wasm:build`);
+  return entry;
+}
+
+// The Emscripten glue, built with EXPORT_ES6: its default export is the factory
+function loadFactory(name: string) {
+  return memo(factories, name, async () => {
+    const { js } = await manifestEntry(name);
+    const mod = await import(/* @vite-ignore */ `${WASM_BASE}${js}`);
+    return mod.default as ModuleFactory;
+  });
+}
+
+// Compiles while the bytes stream in. Servers that do not send
+// application/wasm make compileStreaming throw a TypeError; those fall back
+// to compiling the whole buffer.
+function compileWasm(name: string) {
+  return memo(compiled, name, async () => {
+    const url = `${WASM_BASE}${(await manifestEntry(name)).wasm}`;
+    try {
+      return await WebAssembly.compileStreaming(fetch(url));
+    } catch (err) {
+      if (!(err instanceof TypeError)) throw err;
+      const res = await fetch(url);
+      if (!res.ok) throw new Error(`${url}: HTTP ${res.status}`);
+      return WebAssembly.compile(await res.arrayBuffer());
+    }
+  });
+}
+
+async function createInstance(name: string, compiledModule: Promise<WebAssembly.Module>) {
+  const started = performance.now();
+  const [factory, wasmModule] = await Promise.all([loadFactory(name), compiledModule]);
+  let fail: (err: unknown) => void = () => {};
+  const failed = new Promise<never>((_, reject) => (fail = reject));
+  const mod = await Promise.race([
+    factory({
+      // Instantiate the cached compiled module instead of letting the glue fetch its own
+      instantiateWasm: (
+        imports: WebAssembly.Imports,
+        receive: (instance: WebAssembly.Instance, module: WebAssembly.Module) => void
+      ) => {
+        WebAssembly.instantiate(wasmModule, imports).then(
+          (instance) => receive(instance, wasmModule),
+          fail
+        );
+        return {};
+      },
+    }),
+    failed,
+  ]);
+  console.log(
+    `[WASM LOADER] ${name} ready in ${(performance.now() - started).toFixed(1)} ms`
+  );
+  return mod;
+}
+
+// The page-wide instance of a game's module (shared by every mount)
+export function loadWasm(gameName: string) {
+  const name = moduleNameFor(gameName);
+  return memo(instances, name, () => createInstance(name, compileWasm(name)));
+}
+
+// A game's compiled module, e.g. to hand to a worker (WebAssembly.Modules can
+// be posted), and a fresh instance of it on the receiving side
+export const compileWasmFor = (gameName: string) => compileWasm(moduleNameFor(gameName));
+
+export function instantiateWasmFor(gameName: string, wasmModule: WebAssembly.Module) {
+  return createInstance(moduleNameFor(gameName), Promise.resolve(wasmModule));
+}
+
+// Starts downloading and compiling a game's module without instantiating it,
+// e.g. when the menu expects that game next. Errors surface on the real load.
+export function prefetchWasm(gameName: string) {
+  const name = moduleNameFor(gameName);
+  loadFactory(name).catch(() => {});
+  compileWasm(name).catch(() => {});
+}
+
@@ -0,0 +1,54 @@
+// What the engine worker and the page say to each other: the games it hosts,
+// the status words of a published frame and the input event codes.
+
+export type EngineGame = "Snake" | "Pacman" | "FlappyBird";
+
+// Status words every engine publishes with a frame
+export const STATUS = {
+  SCORE: 0,
+  GAME_OVER: 1,
+  WIDTH: 2,
+  HEIGHT: 3,
+  STEP_MS: 4, // the engine's current fixed step
+} as const;
+
+// Per-game words follow the common ones
+export const PACMAN_STATUS = {
+  PELLETS: 5,
+} as const;
+
+// Bird y and scroll are in cells scaled by FP_ONE, published at the step's
+// end; the page blends PREV..Y by how far it is into the next step
+export const FLAPPY_STATUS = {
+  STARTED: 5,
+  BIRD_Y_PREV: 6,
+  BIRD_Y: 7,
+  SCROLL: 8,
+  FP_ONE: 9,
+} as const;
+
+// Input event codes, shared with the engines (cpp/InputRing.h)
+export const INPUT = {
+  DIRECTION: 1, // value: 0=Up, 1=Right, 2=Down, 3=Left
+  FLAP: 2,
+} as const;
+
+// Pending input events the ring holds before the page's pushes are dropped
+export const INPUT_CAPACITY = 64;
+
+export type ToWorker =
+  | { type: "init"; game: EngineGame; wasmModule: WebAssembly.Module }
+  | { type: "start" }
+  // Only without shared memory; otherwise the page writes the input ring itself
+  | { type: "input"; code: number; value: number; time: number };
+
+export type FromWorker =
+  | {
+      type: "ready";
+      frames: ArrayBuffer | SharedArrayBuffer;
+      inputs: ArrayBuffer | SharedArrayBuffer;
+      shared: boolean;
+    }
+  // Only without shared memory: a copy of the frame channel after a publish
+  | { type: "frame"; frames: ArrayBuffer }
+  | { type: "error"; message: string };
@@ -35,6 +35,14 @@ export function wasmBuilderPlugin() {
     return [];
   };
 
+  const loadManifest = () => {
+    try {
+      return JSON.parse(readFileSync(path.resolve("public/wasm/manifest.json"), "utf8"));
+    } catch {
+      return {};
+    }
+  };
+
   // Save current games list
   const saveGamesList = (games) => {
     try {
@@ -50,11 +58,13 @@ export function wasmBuilderPlugin() {
     const previousGames = loadPreviousGames();
 
     // Build needed if games list changed or WASM files don't exist
+    // (published under content-hashed names listed in manifest.json)
     const gamesChanged =
       JSON.stringify(currentGames) !== JSON.stringify(previousGames);
+    const manifest = loadManifest();
     const wasmMissing = !currentGames.every((game) => {
-      const gameName = path.basename(game, ".cpp");
-      return existsSync(path.resolve("public/wasm", `${gameName}.wasm`));
+      const entry = manifest[path.basename(game, ".cpp")];
+      return !!entry && existsSync(path.resolve("public/wasm", entry.wasm));
     });
 
     if (gamesChanged) {
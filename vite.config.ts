@@ -4,6 +4,14 @@ import { VitePWA } from "vite-plugin-pwa";
 // @ts-expect-error - wasmBuilderPlugin has no types
 import { wasmBuilderPlugin } from "./vite-wasm-plugin.js";
 
+// Cross-origin isolation lets the engine worker share its frame channel and
+// input ring with the page as SharedArrayBuffers. Hosts that cannot send these
+// headers (GitHub Pages) still work, through postMessage copies instead.
+const crossOriginIsolation = {
+  "Cross-Origin-Opener-Policy": "same-origin",
+  "Cross-Origin-Embedder-Policy": "require-corp",
+};
+
 // https://vite.dev/config/
 export default defineConfig({
   base: "/symbol-arcade/",
@@ -31,13 +39,31 @@ export default defineConfig({
       },
       workbox: {
         maximumFileSizeToCacheInBytes: 5000000,
-        globPatterns: ["**/*.{js,css,html,ico,png,svg,wasm}"],
+        globPatterns: ["**/*.{js,css,html,ico,png,svg,wasm,json}"],
+        // The wasm manifest names the current hashed modules, so a precached copy
+        // would pin stale ones; fetch it from the network and keep it for offline
+        globIgnores: ["**/wasm/manifest.json"],
+        runtimeCaching: [
+          {
+            urlPattern: ({ url }) => url.pathname.endsWith("/wasm/manifest.json"),
+            handler: "NetworkFirst",
+            options: { cacheName: "wasm-manifest" },
+          },
+        ],
       },
     }),
   ],
+  // The engine worker imports the Emscripten glue at runtime, which needs an ES-module worker
+  worker: {
+    format: "es",
+  },
   server: {
     watch: {
       ignored: ["**/wasm_build/**", "**/public/wasm/**"], // Don't watch build outputs
     },
+    headers: crossOriginIsolation,
+  },
+  preview: {
+    headers: crossOriginIsolation,
   },
 });